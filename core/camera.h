@@ -0,0 +1,37 @@
+/*
+ * camera.h Copyright 2024 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#pragma once
+
+#include <cmath>
+
+#include <glm/glm.hpp>
+
+/*
+ * A viewer in the world. The position is in cells, the angle in radians and the zoom is half the width of the
+ * camera plane at unit distance, so the field of view is 2 * atan( zoom ).
+ */
+struct Camera {
+	glm::vec2 position;
+	float angle;
+	float zoom;
+
+	glm::vec2 direction() const { return { std::cos( angle ), std::sin( angle ) }; }
+	float half_fov() const { return std::atan( zoom ); }
+};
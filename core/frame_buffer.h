@@ -0,0 +1,56 @@
+/*
+ * frame_buffer.h Copyright 2024 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+// 0xAARRGGBB
+using Pixel = uint32_t;
+
+constexpr Pixel make_pixel( uint8_t red, uint8_t green, uint8_t blue )
+{
+	return 0xFF000000U | ( static_cast<Pixel>( red ) << 16 ) | ( static_cast<Pixel>( green ) << 8 ) | blue;
+}
+
+struct FrameBuffer {
+	int width;
+	int height;
+	std::vector<Pixel> pixels; // top row first
+
+	FrameBuffer( int width, int height )
+		: width( width ), height( height ), pixels( static_cast<size_t>( width ) * static_cast<size_t>( height ) )
+	{
+	}
+
+	Pixel *row( int line ) { return pixels.data() + static_cast<size_t>( line ) * static_cast<size_t>( width ); }
+	const Pixel *row( int line ) const
+	{
+		return pixels.data() + static_cast<size_t>( line ) * static_cast<size_t>( width );
+	}
+};
+
+// a region of a frame buffer one camera renders into
+struct Viewport {
+	int x;
+	int y;
+	int width;
+	int height;
+};
@@ -0,0 +1,173 @@
+/*
+ * grid.cc Copyright 2024 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#include "grid.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <stdexcept>
+
+Grid::Grid( glm::ivec2 dimension, std::string cells ) : world_dimension( dimension ), cells( std::move( cells ) )
+{
+	if( this->cells.size() != static_cast<size_t>( world_dimension[0] ) * static_cast<size_t>( world_dimension[1] ) )
+		throw std::invalid_argument( "Grid cells do not match its dimension" );
+}
+
+Grid Grid::load( const std::string &path )
+{
+	std::ifstream stream( path );
+	if( !stream )
+		throw std::runtime_error( "Cannot open level " + path );
+
+	std::string line;
+	std::string cells;
+	glm::ivec2 dimension{ 0, 0 };
+
+	while( std::getline( stream, line ) ) {
+		if( !line.empty() && line.back() == '\r' )
+			line.pop_back();
+
+		if( line.empty() || line.front() == '#' )
+			continue;
+
+		if( line.find_first_not_of( "01" ) != std::string::npos )
+			throw std::runtime_error( path + ": row " + std::to_string( dimension[1] + 1 ) + " is not made of 0 and 1" );
+
+		if( dimension[1] == 0 )
+			dimension[0] = static_cast<int>( line.size() );
+		else if( static_cast<int>( line.size() ) != dimension[0] )
+			throw std::runtime_error( path + ": row " + std::to_string( dimension[1] + 1 ) + " has the wrong length" );
+
+		cells += line;
+		++dimension[1];
+	}
+
+	if( dimension[1] == 0 )
+		throw std::runtime_error( path + ": level is empty" );
+
+	return { dimension, cells };
+}
+
+// adapted based on https://www.youtube.com/watch?v=NbSee-XM7WA
+GridHit Grid::calc_intersection( float angle, glm::vec2 ray_start ) const
+{
+	constexpr int x_dim = 0;
+	constexpr int y_dim = 1;
+
+	const glm::vec2 ray_dir = { std::cos( angle ), std::sin( angle ) };
+
+	const glm::ivec2 step = { ( ray_dir[x_dim] < 0 ) ? -1 : 1, ( ray_dir[y_dim] < 0 ) ? -1 : 1 };
+
+	const glm::vec2 unit_step_size = {
+		std::sqrt( 1 + ( ray_dir[y_dim] / ray_dir[x_dim] ) * ( ray_dir[y_dim] / ray_dir[x_dim] ) ),
+		std::sqrt( 1 + ( ray_dir[x_dim] / ray_dir[y_dim] ) * ( ray_dir[x_dim] / ray_dir[y_dim] ) ) };
+
+	glm::ivec2 cell_to_test = ray_start;
+	const glm::vec2 first_offset = ( ray_start - glm::vec2( cell_to_test ) );
+	glm::vec2 ray_length_by_dimension = {
+		( ( ray_dir[x_dim] < 0 ) ? first_offset[x_dim] : ( 1.0F - first_offset[x_dim] ) ) * unit_step_size[x_dim],
+		( ( ray_dir[y_dim] < 0 ) ? first_offset[y_dim] : ( 1.0F - first_offset[y_dim] ) ) * unit_step_size[y_dim] };
+
+	constexpr float max_distance = 100.0;
+	float current_side_distance = 0.0;
+	bool wall_found = false;
+	int walk_side = -1;
+
+	while( !wall_found && current_side_distance < max_distance ) {
+
+		walk_side = ( ray_length_by_dimension[x_dim] < ray_length_by_dimension[y_dim] ) ? x_dim : y_dim;
+
+		cell_to_test[walk_side] += step[walk_side];
+		current_side_distance = ray_length_by_dimension[walk_side];
+		ray_length_by_dimension[walk_side] += unit_step_size[walk_side];
+
+		wall_found = is_wall( cell_to_test );
+	}
+
+	if( !wall_found )
+		return { -1, glm::ivec2(), glm::vec2() };
+
+	return { walk_side, cell_to_test, ray_start + ray_dir * current_side_distance };
+}
+
+bool Grid::is_wall( glm::ivec2 cell ) const
+{
+	constexpr int x_dim = 0;
+	constexpr int y_dim = 1;
+
+	if( cell[x_dim] < 0 || cell[x_dim] >= world_dimension[x_dim] || cell[y_dim] < 0 ||
+		cell[y_dim] >= world_dimension[y_dim] )
+		return false;
+
+	return cells[cell_index( cell )] == '1';
+}
+
+GridPatch Grid::diff( const Grid &other ) const
+{
+	if( other.world_dimension != world_dimension )
+		return { other.world_dimension, { { 0, 0 }, other.world_dimension }, other.cells };
+
+	const auto width = static_cast<std::ptrdiff_t>( world_dimension[0] );
+	GridRegion changed{ world_dimension, { 0, 0 } };
+
+	for( int line = 0; line < world_dimension[1]; ++line ) {
+		const auto first = cells.begin() + line * width;
+		const auto other_first = other.cells.begin() + line * width;
+
+		const auto from = std::mismatch( first, first + width, other_first ).first;
+		if( from == first + width )
+			continue;
+
+		const auto to = std::mismatch( std::make_reverse_iterator( first + width ), std::make_reverse_iterator( from ),
+									   std::make_reverse_iterator( other_first + width ) )
+							.first.base();
+
+		changed.min = { std::min( changed.min[0], static_cast<int>( from - first ) ), std::min( changed.min[1], line ) };
+		changed.max = { std::max( changed.max[0], static_cast<int>( to - first ) ), line + 1 };
+	}
+
+	GridPatch patch{ world_dimension, changed, {} };
+
+	if( changed.empty() )
+		return patch;
+
+	const auto region_width = static_cast<size_t>( changed.max[0] - changed.min[0] );
+	patch.cells.reserve( region_width * static_cast<size_t>( changed.max[1] - changed.min[1] ) );
+
+	for( int line = changed.min[1]; line < changed.max[1]; ++line )
+		patch.cells.append( other.cells, static_cast<size_t>( other.cell_index( { changed.min[0], line } ) ),
+							region_width );
+
+	return patch;
+}
+
+void Grid::apply( GridPatch patch )
+{
+	if( patch.dimension != world_dimension ) {
+		*this = Grid( patch.dimension, std::move( patch.cells ) );
+		return;
+	}
+
+	const auto region_width = static_cast<size_t>( patch.region.max[0] - patch.region.min[0] );
+
+	for( int line = patch.region.min[1]; line < patch.region.max[1]; ++line )
+		cells.replace( static_cast<size_t>( cell_index( { patch.region.min[0], line } ) ), region_width, patch.cells,
+					   static_cast<size_t>( line - patch.region.min[1] ) * region_width, region_width );
+}
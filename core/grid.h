@@ -0,0 +1,76 @@
+/*
+ * grid.h Copyright 2024 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#pragma once
+
+#include <string>
+
+#include <glm/glm.hpp>
+
+struct GridHit {
+	int side; // the axis of the grid line that was crossed, -1 when the ray hit nothing
+	glm::ivec2 cell;
+	glm::vec2 point;
+};
+
+// a block of cells, max is exclusive
+struct GridRegion {
+	glm::ivec2 min;
+	glm::ivec2 max;
+
+	bool empty() const { return min[0] >= max[0] || min[1] >= max[1]; }
+};
+
+// the cells of one region of a grid, row by row; the region is the whole grid when the dimension changed
+struct GridPatch {
+	glm::ivec2 dimension;
+	GridRegion region;
+	std::string cells;
+};
+
+/*
+ * The tile grid the rays are cast through. Coordinates are in cells, a '1' cell is a wall.
+ * Holds no SDL state, so it can be shared read-only between threads.
+ */
+class Grid
+{
+public:
+	Grid( glm::ivec2 dimension, std::string cells );
+
+	// one row of '0' and '1' per line, lines starting with '#' are ignored
+	static Grid load( const std::string &path );
+
+	glm::ivec2 dimension() const { return world_dimension; }
+
+	int cell_index( glm::ivec2 cell ) const { return cell[0] + cell[1] * world_dimension[0]; }
+
+	bool is_wall( glm::ivec2 cell ) const;
+
+	// the bounding box of the cells other changes, with other's cells inside it
+	GridPatch diff( const Grid &other ) const;
+
+	// only touches the rows and columns of the patch's region
+	void apply( GridPatch patch );
+
+	GridHit calc_intersection( float angle, glm::vec2 ray_start ) const;
+
+private:
+	glm::ivec2 world_dimension;
+	std::string cells;
+};
@@ -0,0 +1,47 @@
+/*
+ * hit_buffer.h Copyright 2024 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/*
+ * What the cast stage found for each screen column, one array per field so the shade stage only streams the
+ * fields it reads.
+ */
+struct HitBuffer {
+	std::vector<float> distance;  // along the view direction, 0 when the ray hit nothing
+	std::vector<int8_t> side;	  // the axis of the grid line that was crossed, -1 when the ray hit nothing
+	std::vector<int32_t> cell;	  // index of the wall cell or segment, -1 when the ray hit nothing
+	std::vector<float> texture_u; // 0 to 1 across the face of the wall
+
+	explicit HitBuffer( size_t columns = 0 ) { resize( columns ); }
+
+	size_t size() const { return distance.size(); }
+
+	void resize( size_t columns )
+	{
+		distance.resize( columns );
+		side.resize( columns );
+		cell.resize( columns );
+		texture_u.resize( columns );
+	}
+};
@@ -0,0 +1,205 @@
+/*
+ * level_watcher.cc Copyright 2024 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#include "level_watcher.h"
+
+#include <chrono>
+#include <iostream>
+#include <stdexcept>
+
+#ifdef __linux__
+#include <array>
+#include <cstring>
+
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+LevelWatcher::LevelWatcher( std::filesystem::path path, Grid level )
+	: path( std::move( path ) ), base( std::move( level ) )
+{
+#ifdef __linux__
+	const std::filesystem::path directory = this->path.has_parent_path() ? this->path.parent_path() : ".";
+
+	notify_fd = inotify_init1( IN_NONBLOCK | IN_CLOEXEC );
+	stop_fd = eventfd( 0, EFD_CLOEXEC );
+
+	if( notify_fd < 0 || stop_fd < 0 ||
+		inotify_add_watch( notify_fd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO ) < 0 ) {
+		const std::string reason = std::strerror( errno );
+
+		if( notify_fd >= 0 )
+			close( notify_fd );
+		if( stop_fd >= 0 )
+			close( stop_fd );
+
+		throw std::runtime_error( "Cannot watch " + directory.string() + ": " + reason );
+	}
+#else
+	last_write = std::filesystem::last_write_time( this->path );
+#endif
+
+	watcher = std::thread( [this]() { watch(); } );
+}
+
+LevelWatcher::~LevelWatcher()
+{
+	stopping = true;
+
+#ifdef __linux__
+	const uint64_t one = 1;
+	[[maybe_unused]] const ssize_t written = write( stop_fd, &one, sizeof( one ) );
+#else
+	{
+		const std::lock_guard<std::mutex> lock( mutex );
+	}
+	wake.notify_one();
+#endif
+
+	watcher.join();
+
+#ifdef __linux__
+	close( notify_fd );
+	close( stop_fd );
+#endif
+}
+
+std::optional<GridPatch> LevelWatcher::poll()
+{
+	const std::lock_guard<std::mutex> lock( mutex );
+
+	if( !pending )
+		return std::nullopt;
+
+	std::optional<GridPatch> patch = std::move( pending );
+	pending.reset();
+
+	delivered = std::move( pending_level );
+	pending_level.reset();
+
+	return patch;
+}
+
+void LevelWatcher::watch()
+{
+	while( wait_for_change() ) {
+		try {
+			publish( Grid::load( path.string() ) );
+		} catch( const std::exception &error ) {
+			std::clog << "Level not reloaded: " << error.what() << '\n';
+		}
+	}
+}
+
+// the diff runs unlocked, if the caller takes the previous patch meanwhile it is redone against that
+void LevelWatcher::publish( Grid level )
+{
+	while( true ) {
+		{
+			const std::lock_guard<std::mutex> lock( mutex );
+
+			if( delivered ) {
+				base = std::move( *delivered );
+				delivered.reset();
+			}
+		}
+
+		GridPatch patch = base.diff( level );
+
+		const std::lock_guard<std::mutex> lock( mutex );
+
+		if( delivered )
+			continue;
+
+		// an edit that was undone before the caller saw it leaves nothing to apply
+		if( patch.region.empty() ) {
+			pending.reset();
+			pending_level.reset();
+		} else {
+			pending = std::move( patch );
+			pending_level = std::move( level );
+		}
+
+		return;
+	}
+}
+
+#ifdef __linux__
+
+// false once the watcher is stopping
+bool LevelWatcher::wait_for_change()
+{
+	const std::string name = path.filename().string();
+
+	// inotify events are variable length, this is the alignment the man page asks for
+	alignas( inotify_event ) std::array<char, 4096> buffer;
+
+	while( true ) {
+		std::array<pollfd, 2> fds = { { { notify_fd, POLLIN, 0 }, { stop_fd, POLLIN, 0 } } };
+
+		if( ::poll( fds.data(), fds.size(), -1 ) < 0 && errno != EINTR )
+			return false;
+
+		if( stopping )
+			return false;
+
+		bool changed = false;
+		ssize_t length = 0;
+
+		while( ( length = read( notify_fd, buffer.data(), buffer.size() ) ) > 0 )
+			for( ssize_t offset = 0; offset < length; ) {
+				const auto *event = reinterpret_cast<const inotify_event *>( buffer.data() + offset );
+
+				if( event->len > 0 && name == event->name )
+					changed = true;
+
+				offset += static_cast<ssize_t>( sizeof( inotify_event ) + event->len );
+			}
+
+		if( changed )
+			return true;
+	}
+}
+
+#else
+
+bool LevelWatcher::wait_for_change()
+{
+	using namespace std::chrono_literals;
+
+	while( true ) {
+		{
+			std::unique_lock<std::mutex> lock( mutex );
+			if( wake.wait_for( lock, 250ms, [this]() { return stopping.load(); } ) )
+				return false;
+		}
+
+		std::error_code error;
+		const auto write_time = std::filesystem::last_write_time( path, error );
+
+		if( !error && write_time != last_write ) {
+			last_write = write_time;
+			return true;
+		}
+	}
+}
+
+#endif
@@ -0,0 +1,78 @@
+/*
+ * level_watcher.h Copyright 2024 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#pragma once
+
+#include "grid.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <filesystem>
+#include <mutex>
+#include <optional>
+#include <thread>
+
+/*
+ * Reloads a level file whenever it is written. A background thread waits for the change, inotify on Linux and a
+ * modification time check elsewhere, parses the file and diffs it against the level the caller holds, so the
+ * render loop only ever picks up a finished patch of the changed cells. The directory is watched rather than the
+ * file, because most editors save by renaming a new file over the old one. A level that fails to parse is
+ * reported on std::clog and skipped.
+ */
+class LevelWatcher
+{
+public:
+	// level is what the caller holds now, every patch is relative to it plus the patches before
+	LevelWatcher( std::filesystem::path path, Grid level );
+	~LevelWatcher();
+
+	LevelWatcher( const LevelWatcher &other ) = delete;
+	LevelWatcher( LevelWatcher &&other ) = delete;
+	LevelWatcher &operator=( const LevelWatcher &other ) = delete;
+	LevelWatcher &operator=( LevelWatcher &&other ) = delete;
+
+	// the changes since the last patch taken, if there are any; never blocks on the file or a diff
+	std::optional<GridPatch> poll();
+
+private:
+	bool wait_for_change();
+	void watch();
+	void publish( Grid level );
+
+	std::filesystem::path path;
+
+	// what the caller holds once it has applied every patch taken so far, only the watcher thread touches it
+	Grid base;
+
+	std::mutex mutex;
+	std::optional<GridPatch> pending;
+	std::optional<Grid> pending_level;
+
+	// the level of the last patch taken, waiting for the watcher thread to make it the new base
+	std::optional<Grid> delivered;
+
+	std::atomic<bool> stopping = false;
+	std::condition_variable wake;
+	std::filesystem::file_time_type last_write;
+
+	int notify_fd = -1;
+	int stop_fd = -1;
+
+	std::thread watcher;
+};
@@ -0,0 +1,208 @@
+/*
+ * perf_counters.cc Copyright 2024 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#include "perf_counters.h"
+
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <utility>
+
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace
+{
+
+struct CounterEvent {
+	uint32_t type;
+	uint64_t config;
+	uint64_t PerfSample::*field;
+};
+
+// cycles leads the group, so it has to be first
+constexpr std::array<CounterEvent, PerfCounters::counter_count> events = { {
+	{ PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES, &PerfSample::cycles },
+	{ PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS, &PerfSample::instructions },
+	{ PERF_TYPE_HW_CACHE,
+	  PERF_COUNT_HW_CACHE_L1D | ( PERF_COUNT_HW_CACHE_OP_READ << 8 ) | ( PERF_COUNT_HW_CACHE_RESULT_MISS << 16 ),
+	  &PerfSample::l1d_misses },
+	{ PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES, &PerfSample::llc_misses },
+	{ PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES, &PerfSample::branch_misses },
+} };
+
+int open_counter( const CounterEvent &event, int group_fd )
+{
+	perf_event_attr attr{};
+
+	attr.size = sizeof( attr );
+	attr.type = event.type;
+	attr.config = event.config;
+	attr.disabled = group_fd < 0 ? 1 : 0;
+	attr.exclude_kernel = 1;
+	attr.exclude_hv = 1;
+	attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+	return static_cast<int>( syscall( SYS_perf_event_open, &attr, 0, -1, group_fd, 0 ) );
+}
+
+std::string paranoid_level()
+{
+	std::ifstream stream( "/proc/sys/kernel/perf_event_paranoid" );
+	std::string level = "unknown";
+	stream >> level;
+	return level;
+}
+
+double per( uint64_t count, uint64_t divisor ) { return static_cast<double>( count ) / static_cast<double>( divisor ); }
+
+} // namespace
+
+PerfCounters::PerfCounters( uint64_t report_interval ) : report_interval( report_interval )
+{
+	fds.fill( -1 );
+	slots.fill( -1 );
+
+	for( size_t counter = 0; counter < events.size(); ++counter ) {
+		fds[counter] = open_counter( events[counter], group_fd );
+
+		if( fds[counter] < 0 ) {
+			if( counter == 0 ) {
+				std::clog << "Performance counters unavailable: " << std::strerror( errno )
+						  << " (kernel.perf_event_paranoid is " << paranoid_level() << ")\n";
+				return;
+			}
+			continue;
+		}
+
+		if( counter == 0 )
+			group_fd = fds[counter];
+
+		slots[counter] = opened++;
+	}
+
+	ioctl( group_fd, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP );
+	ioctl( group_fd, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP );
+}
+
+PerfCounters::~PerfCounters()
+{
+	for( const int fd : fds )
+		if( fd >= 0 )
+			close( fd );
+}
+
+// the group stays enabled, a phase is the difference of two reads, which costs one syscall at each end
+std::optional<PerfReading> PerfCounters::read() const
+{
+	// the group layout: the number of counters, the time enabled, the time running, then each value in the
+	// order they were opened
+	constexpr size_t header_size = 3;
+
+	if( group_fd < 0 )
+		return std::nullopt;
+
+	std::array<uint64_t, header_size + counter_count> values{};
+	const auto expected = static_cast<ssize_t>( ( header_size + static_cast<size_t>( opened ) ) * sizeof( uint64_t ) );
+
+	if( ::read( group_fd, values.data(), sizeof( values ) ) < expected )
+		return std::nullopt;
+
+	PerfReading reading{ {}, values[1], values[2] };
+
+	for( size_t counter = 0; counter < events.size(); ++counter )
+		if( slots[counter] >= 0 )
+			reading.sample.*events[counter].field = values[header_size + slots[counter]];
+
+	return reading;
+}
+
+// a phase with a failed read at either end is left out rather than counted from zero
+void PerfCounters::end( PerfPhase &phase )
+{
+	const std::optional<PerfReading> now = read();
+	const std::optional<PerfReading> start = std::exchange( phase.start, std::nullopt );
+
+	if( !now || !start )
+		return;
+
+	// the group was off the PMU for the whole stretch, its counts say nothing
+	const uint64_t running = now->time_running - start->time_running;
+	if( running == 0 )
+		return;
+
+	const double scale = per( now->time_enabled - start->time_enabled, running );
+	const auto delta = [&]( uint64_t PerfSample::*field ) {
+		return static_cast<uint64_t>( static_cast<double>( now->sample.*field - start->sample.*field ) * scale + 0.5 );
+	};
+
+	phase.total += { delta( &PerfSample::cycles ), delta( &PerfSample::instructions ), delta( &PerfSample::l1d_misses ),
+					 delta( &PerfSample::llc_misses ), delta( &PerfSample::branch_misses ) };
+	++phase.measured;
+}
+
+void PerfCounters::end_frame( std::span<PerfPhase> phases, uint64_t items_per_frame, const char *item_name )
+{
+	if( group_fd < 0 || ++frames < report_interval )
+		return;
+
+	const auto report = [&]( const char *label, uint64_t PerfSample::*field, const PerfPhase &phase,
+							 size_t counter ) {
+		std::clog << "  " << label << " ";
+
+		if( slots[counter] < 0 ) {
+			std::clog << "n/a";
+			return;
+		}
+
+		std::clog << per( phase.total.*field, phase.measured ) << "/frame "
+				  << per( phase.total.*field, phase.measured * items_per_frame ) << "/" << item_name;
+	};
+
+	std::clog << std::fixed << std::setprecision( 2 );
+
+	for( PerfPhase &phase : phases ) {
+		const PerfSample &total = phase.total;
+
+		std::clog << phase.name << ":";
+
+		if( phase.measured == 0 )
+			std::clog << " n/a, the counters never got onto the PMU\n";
+		else {
+			report( "cycles", &PerfSample::cycles, phase, 0 );
+			report( "instructions", &PerfSample::instructions, phase, 1 );
+			std::clog << " (IPC " << ( total.cycles != 0 ? per( total.instructions, total.cycles ) : 0.0 ) << ")";
+			report( "L1D misses", &PerfSample::l1d_misses, phase, 2 );
+			report( "LLC misses", &PerfSample::llc_misses, phase, 3 );
+			report( "branch misses", &PerfSample::branch_misses, phase, 4 );
+			std::clog << '\n';
+		}
+
+		phase.total = {};
+		phase.measured = 0;
+	}
+
+	std::clog << std::defaultfloat;
+	frames = 0;
+}
@@ -0,0 +1,121 @@
+/*
+ * perf_counters.h Copyright 2024 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <span>
+
+struct PerfSample {
+	uint64_t cycles = 0;
+	uint64_t instructions = 0;
+	uint64_t l1d_misses = 0;
+	uint64_t llc_misses = 0;
+	uint64_t branch_misses = 0;
+
+	PerfSample &operator+=( const PerfSample &other )
+	{
+		cycles += other.cycles;
+		instructions += other.instructions;
+		l1d_misses += other.l1d_misses;
+		llc_misses += other.llc_misses;
+		branch_misses += other.branch_misses;
+		return *this;
+	}
+};
+
+// the counters plus how long the group was enabled and how long it was actually on the PMU, in nanoseconds
+struct PerfReading {
+	PerfSample sample;
+	uint64_t time_enabled = 0;
+	uint64_t time_running = 0;
+};
+
+// one measured stretch of a frame, summed over frames until it is reported
+struct PerfPhase {
+	const char *name;
+	PerfSample total{};
+	uint64_t measured = 0; // stretches in total, a stretch the group never ran in is not counted
+	std::optional<PerfReading> start{};
+};
+
+#ifdef RAYCAST_PERF_COUNTERS
+
+/*
+ * Hardware counters for the thread that creates this object, read through perf_event_open as a single group so
+ * every phase sees the same instructions. When the kernel shares the PMU with other users the group is multiplexed
+ * and its counts are scaled up by the time it was enabled over the time it ran; a phase it never ran in reports
+ * n/a. Only user space is counted, which is what lets it run without root as
+ * long as kernel.perf_event_paranoid is 2 or lower. If the counters cannot be opened a warning is printed once and
+ * every call does nothing.
+ */
+class PerfCounters
+{
+public:
+	explicit PerfCounters( uint64_t report_interval = 120 );
+	~PerfCounters();
+
+	PerfCounters( const PerfCounters &other ) = delete;
+	PerfCounters( PerfCounters &&other ) = delete;
+	PerfCounters &operator=( const PerfCounters &other ) = delete;
+	PerfCounters &operator=( PerfCounters &&other ) = delete;
+
+	bool available() const { return group_fd >= 0; }
+
+	void begin( PerfPhase &phase ) { phase.start = read(); }
+	void end( PerfPhase &phase );
+
+	// every report_interval frames, prints each phase per frame and per item to std::clog and clears it
+	void end_frame( std::span<PerfPhase> phases, uint64_t items_per_frame, const char *item_name );
+
+	static constexpr int counter_count = 5;
+
+private:
+	// empty when the group could not be read
+	std::optional<PerfReading> read() const;
+
+	int group_fd = -1;
+	std::array<int, counter_count> fds;
+
+	// position of each counter in the group read, -1 when the CPU does not have it
+	std::array<int, counter_count> slots;
+	int opened = 0;
+
+	uint64_t report_interval;
+	uint64_t frames = 0;
+};
+
+#else
+
+// instrumentation is off, everything here compiles to nothing
+class PerfCounters
+{
+public:
+	explicit PerfCounters( uint64_t /*unused*/ = 0 ) {}
+
+	static constexpr bool available() { return false; }
+
+	void begin( PerfPhase & /*unused*/ ) {}
+	void end( PerfPhase & /*unused*/ ) {}
+	void end_frame( std::span<PerfPhase> /*unused*/, uint64_t /*unused*/, const char * /*unused*/ ) {}
+};
+
+#endif
@@ -0,0 +1,99 @@
+/*
+ * ray_cast.cc Copyright 2024 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#include "ray_cast.h"
+
+#include <cmath>
+
+void cast_rays( const Grid &grid, const Camera &camera, HitBuffer &hits )
+{
+	cast_rays( grid, camera, hits.size(), 0, hits );
+}
+
+void cast_rays( const Grid &grid, const Camera &camera, size_t total_columns, size_t first_column, HitBuffer &hits )
+{
+	const glm::vec2 view_dir = camera.direction();
+
+	const float first_angle = camera.angle - camera.half_fov();
+	const float delta_angle = 2.0F * camera.half_fov() / static_cast<float>( total_columns );
+
+	for( size_t column = 0; column < hits.size(); ++column ) {
+		const GridHit hit = grid.calc_intersection(
+			first_angle + delta_angle * static_cast<float>( first_column + column ), camera.position );
+
+		if( hit.side == -1 ) {
+			hits.distance[column] = 0.0F;
+			hits.side[column] = -1;
+			hits.cell[column] = -1;
+			hits.texture_u[column] = 0.0F;
+			continue;
+		}
+
+		// credit: https://www.youtube.com/watch?v=eOCQfxRQ2pY
+		hits.distance[column] = glm::dot( hit.point - camera.position, view_dir );
+		hits.side[column] = static_cast<int8_t>( hit.side );
+		hits.cell[column] = grid.cell_index( hit.cell );
+
+		// a wall crossed on the x axis runs along y, and the other way round
+		const float along_wall = hit.point[1 - hit.side];
+		hits.texture_u[column] = along_wall - std::floor( along_wall );
+	}
+}
+
+void cast_rays( const SegmentWorld &world, const Camera &camera, HitBuffer &hits )
+{
+	cast_rays( world, camera, hits.size(), 0, hits );
+}
+
+void cast_rays( const SegmentWorld &world, const Camera &camera, size_t total_columns, size_t first_column,
+				HitBuffer &hits )
+{
+	const glm::vec2 view_dir = camera.direction();
+
+	const float first_angle = camera.angle - camera.half_fov();
+	const float delta_angle = 2.0F * camera.half_fov() / static_cast<float>( total_columns );
+
+	for( size_t column = 0; column < hits.size(); ++column ) {
+		const float ray_angle = first_angle + delta_angle * static_cast<float>( first_column + column );
+		const glm::vec2 ray_dir = { std::cos( ray_angle ), std::sin( ray_angle ) };
+
+		const SegmentHit hit = world.intersect( camera.position, ray_dir );
+
+		if( hit.segment == -1 ) {
+			hits.distance[column] = 0.0F;
+			hits.side[column] = -1;
+			hits.cell[column] = -1;
+			hits.texture_u[column] = 0.0F;
+			continue;
+		}
+
+		const Segment &segment = world.segments()[hit.segment];
+		const glm::vec2 edge = segment.to - segment.from;
+
+		hits.distance[column] = hit.distance * glm::dot( ray_dir, view_dir );
+		hits.cell[column] = hit.segment;
+
+		// shade like the grid: walls running mostly along x look like crossed y lines
+		hits.side[column] = ( std::fabs( edge[0] ) > std::fabs( edge[1] ) ) ? 1 : 0;
+
+		// one texture repeat per cell of wall length
+		const float along_wall = hit.along * glm::length( edge );
+		hits.texture_u[column] = along_wall - std::floor( along_wall );
+	}
+}
@@ -0,0 +1,38 @@
+/*
+ * ray_cast.h Copyright 2024 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#pragma once
+
+#include "camera.h"
+#include "grid.h"
+#include "hit_buffer.h"
+#include "segment_world.h"
+
+#include <cstddef>
+
+// the cast stage: sweeps hits.size() rays evenly across the camera's field of view, left to right
+void cast_rays( const Grid &grid, const Camera &camera, HitBuffer &hits );
+
+// casts only columns [first_column, first_column + hits.size()) of a view total_columns wide
+void cast_rays( const Grid &grid, const Camera &camera, size_t total_columns, size_t first_column, HitBuffer &hits );
+
+// the same for a segment world, cell then holds the segment index
+void cast_rays( const SegmentWorld &world, const Camera &camera, HitBuffer &hits );
+void cast_rays( const SegmentWorld &world, const Camera &camera, size_t total_columns, size_t first_column,
+				HitBuffer &hits );
@@ -0,0 +1,99 @@
+/*
+ * render_view.cc Copyright 2024 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#include "render_view.h"
+
+#include "hit_buffer.h"
+#include "ray_cast.h"
+#include "shade.h"
+
+#include <array>
+#include <cmath>
+
+namespace
+{
+
+template <typename World>
+void render_columns( const World &world, const Camera &camera, const Viewport &viewport, int first_column,
+					 int column_count, FrameBuffer &frame )
+{
+	constexpr Pixel blue = make_pixel( 0, 0, 204 );
+	constexpr Pixel green = make_pixel( 0, 255, 0 );
+	constexpr std::array<Pixel, 3> shades = { make_pixel( 0, 0, 0 ), make_pixel( 127, 127, 127 ),
+											  make_pixel( 191, 191, 191 ) };
+
+	// scratch for whichever thread renders this strip
+	thread_local HitBuffer hits;
+	thread_local ColumnSpans spans;
+
+	// the interactive view projects walls at 400 pixels per cell of distance on a 480 line window
+	const float wall_scale = 400.0F * static_cast<float>( viewport.height ) / 480.0F;
+	const int horizon = viewport.height / 2;
+
+	hits.resize( column_count );
+	cast_rays( world, camera, viewport.width, first_column, hits );
+	shade_columns( hits, wall_scale, viewport.height, spans );
+
+	// row by row, so each strip is written front to back
+	for( int row = 0; row < viewport.height; ++row ) {
+		const Pixel background = ( row < horizon ) ? blue : green;
+		Pixel *pixel = frame.row( viewport.y + row ) + viewport.x + first_column;
+
+		for( int column = 0; column < column_count; ++column ) {
+			const bool is_wall = row >= spans.top[column] && row < spans.bottom[column];
+			pixel[column] = is_wall ? shades[spans.shade[column]] : background;
+		}
+	}
+}
+
+} // namespace
+
+void render_view_columns( const Grid &grid, const Camera &camera, const Viewport &viewport, int first_column,
+						  int column_count, FrameBuffer &frame )
+{
+	render_columns( grid, camera, viewport, first_column, column_count, frame );
+}
+
+void render_view_columns( const SegmentWorld &world, const Camera &camera, const Viewport &viewport, int first_column,
+						  int column_count, FrameBuffer &frame )
+{
+	render_columns( world, camera, viewport, first_column, column_count, frame );
+}
+
+std::vector<Viewport> tile_viewports( int view_count, int width, int height )
+{
+	const auto columns = static_cast<int>( std::ceil( std::sqrt( static_cast<float>( view_count ) ) ) );
+	const int rows = ( view_count + columns - 1 ) / columns;
+
+	std::vector<Viewport> viewports;
+
+	for( int view = 0; view < view_count; ++view ) {
+		const int column = view % columns;
+		const int row = view / columns;
+
+		// spread the remainder so the viewports cover the frame exactly
+		const int left = width * column / columns;
+		const int top = height * row / rows;
+
+		viewports.push_back(
+			{ left, top, width * ( column + 1 ) / columns - left, height * ( row + 1 ) / rows - top } );
+	}
+
+	return viewports;
+}
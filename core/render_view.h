@@ -0,0 +1,47 @@
+/*
+ * render_view.h Copyright 2024 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#pragma once
+
+#include "camera.h"
+#include "frame_buffer.h"
+#include "grid.h"
+#include "segment_world.h"
+
+#include <vector>
+
+// the view TilePaintingGame paints, minus the minimap, into columns [first_column, first_column + column_count)
+void render_view_columns( const Grid &grid, const Camera &camera, const Viewport &viewport, int first_column,
+						  int column_count, FrameBuffer &frame );
+
+void render_view_columns( const SegmentWorld &world, const Camera &camera, const Viewport &viewport, int first_column,
+						  int column_count, FrameBuffer &frame );
+
+inline void render_view( const Grid &grid, const Camera &camera, const Viewport &viewport, FrameBuffer &frame )
+{
+	render_view_columns( grid, camera, viewport, 0, viewport.width, frame );
+}
+
+inline void render_view( const SegmentWorld &world, const Camera &camera, const Viewport &viewport, FrameBuffer &frame )
+{
+	render_view_columns( world, camera, viewport, 0, viewport.width, frame );
+}
+
+// splits a width by height frame into view_count viewports, as square a grid of them as fits
+std::vector<Viewport> tile_viewports( int view_count, int width, int height );
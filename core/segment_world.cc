@@ -0,0 +1,244 @@
+/*
+ * segment_world.cc Copyright 2024 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#include "segment_world.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+
+namespace
+{
+
+float cross( glm::vec2 first, glm::vec2 second ) { return first[0] * second[1] - first[1] * second[0]; }
+
+glm::vec2 centre( const Segment &segment ) { return ( segment.from + segment.to ) * 0.5F; }
+
+// slab test, returns the distance at which the ray enters the box or infinity when it misses
+float enter_box( glm::vec2 box_min, glm::vec2 box_max, glm::vec2 origin, glm::vec2 inverse_dir, float max_distance )
+{
+	float near = 0.0F;
+	float far = max_distance;
+
+	for( const int dim : { 0, 1 } ) {
+		float first = ( box_min[dim] - origin[dim] ) * inverse_dir[dim];
+		float second = ( box_max[dim] - origin[dim] ) * inverse_dir[dim];
+
+		if( first > second )
+			std::swap( first, second );
+
+		near = std::max( near, first );
+		far = std::min( far, second );
+	}
+
+	return ( near <= far ) ? near : std::numeric_limits<float>::infinity();
+}
+
+} // namespace
+
+SegmentWorld::SegmentWorld( std::vector<Segment> walls ) : walls( std::move( walls ) )
+{
+	if( !this->walls.empty() ) {
+		nodes.reserve( 2 * this->walls.size() / leaf_size + 1 );
+		build( 0, static_cast<int>( this->walls.size() ) );
+	}
+}
+
+SegmentWorld SegmentWorld::load( const std::string &path )
+{
+	std::ifstream stream( path );
+	if( !stream )
+		throw std::runtime_error( "Cannot open segments " + path );
+
+	std::vector<Segment> walls;
+	std::string line;
+	int line_number = 0;
+
+	while( std::getline( stream, line ) ) {
+		++line_number;
+
+		if( line.find_first_not_of( " \t\r" ) == std::string::npos || line.front() == '#' )
+			continue;
+
+		std::istringstream fields( line );
+		Segment segment{};
+
+		if( !( fields >> segment.from[0] >> segment.from[1] >> segment.to[0] >> segment.to[1] ) )
+			throw std::runtime_error( path + ":" + std::to_string( line_number ) + ": expected x0 y0 x1 y1" );
+
+		walls.push_back( segment );
+	}
+
+	return SegmentWorld( std::move( walls ) );
+}
+
+SegmentWorld SegmentWorld::from_grid( const Grid &grid )
+{
+	const glm::ivec2 dimension = grid.dimension();
+	std::vector<Segment> walls;
+
+	// a face lies on a grid line wherever the cells on either side of it differ
+	for( const int dim : { 0, 1 } ) {
+		const int other = 1 - dim;
+
+		for( int line = 0; line <= dimension[dim]; ++line ) {
+			int run_start = -1;
+
+			for( int position = 0; position <= dimension[other]; ++position ) {
+				glm::ivec2 before;
+				before[dim] = line - 1;
+				before[other] = position;
+
+				glm::ivec2 after = before;
+				after[dim] = line;
+
+				const bool is_face = position < dimension[other] && grid.is_wall( before ) != grid.is_wall( after );
+
+				if( is_face && run_start == -1 )
+					run_start = position;
+
+				if( !is_face && run_start != -1 ) {
+					Segment segment{};
+					segment.from[dim] = static_cast<float>( line );
+					segment.from[other] = static_cast<float>( run_start );
+					segment.to[dim] = static_cast<float>( line );
+					segment.to[other] = static_cast<float>( position );
+
+					walls.push_back( segment );
+					run_start = -1;
+				}
+			}
+		}
+	}
+
+	return SegmentWorld( std::move( walls ) );
+}
+
+// median split on the longer axis of the centroid bounds
+int SegmentWorld::build( int first, int count )
+{
+	const int index = static_cast<int>( nodes.size() );
+	nodes.push_back( {} );
+
+	glm::vec2 box_min( std::numeric_limits<float>::max() );
+	glm::vec2 box_max( std::numeric_limits<float>::lowest() );
+	glm::vec2 centre_min = box_min;
+	glm::vec2 centre_max = box_max;
+
+	for( int wall = first; wall < first + count; ++wall ) {
+		box_min = glm::min( box_min, glm::min( walls[wall].from, walls[wall].to ) );
+		box_max = glm::max( box_max, glm::max( walls[wall].from, walls[wall].to ) );
+		centre_min = glm::min( centre_min, centre( walls[wall] ) );
+		centre_max = glm::max( centre_max, centre( walls[wall] ) );
+	}
+
+	if( count <= leaf_size ) {
+		nodes[index] = { box_min, box_max, first, count };
+		return index;
+	}
+
+	const int axis = ( centre_max[0] - centre_min[0] >= centre_max[1] - centre_min[1] ) ? 0 : 1;
+	const int half = count / 2;
+
+	std::nth_element( walls.begin() + first, walls.begin() + first + half, walls.begin() + first + count,
+					  [axis]( const Segment &lhs, const Segment &rhs ) {
+						  return centre( lhs )[axis] < centre( rhs )[axis];
+					  } );
+
+	build( first, half );
+	const int right = build( first + half, count - half );
+
+	nodes[index] = { box_min, box_max, right, 0 };
+	return index;
+}
+
+SegmentHit SegmentWorld::intersect( glm::vec2 origin, glm::vec2 direction ) const
+{
+	constexpr float parallel = 1e-9F;
+	constexpr float huge = 1e30F;
+
+	SegmentHit best{ -1, std::numeric_limits<float>::infinity(), 0.0F };
+
+	if( nodes.empty() )
+		return best;
+
+	const glm::vec2 inverse_dir = { ( direction[0] != 0.0F ) ? 1.0F / direction[0] : std::copysign( huge, direction[0] ),
+									( direction[1] != 0.0F ) ? 1.0F / direction[1] : std::copysign( huge, direction[1] ) };
+
+	struct Pending {
+		int node;
+		float enter;
+	};
+
+	// the tree is balanced, 64 levels is far beyond any level that fits in memory
+	std::array<Pending, 64> stack{};
+	int depth = 0;
+
+	stack[depth++] = { 0, enter_box( nodes[0].min, nodes[0].max, origin, inverse_dir, best.distance ) };
+
+	while( depth > 0 ) {
+		const Pending pending = stack[--depth];
+
+		// a closer wall was found since this node was pushed
+		if( pending.enter >= best.distance )
+			continue;
+
+		const Node &node = nodes[pending.node];
+
+		if( node.count > 0 ) {
+			for( int wall = node.first; wall < node.first + node.count; ++wall ) {
+				const glm::vec2 edge = walls[wall].to - walls[wall].from;
+				const float denominator = cross( direction, edge );
+
+				if( std::fabs( denominator ) < parallel )
+					continue;
+
+				const glm::vec2 to_start = walls[wall].from - origin;
+				const float distance = cross( to_start, edge ) / denominator;
+				const float along = cross( to_start, direction ) / denominator;
+
+				if( distance > 0.0F && distance < best.distance && along >= 0.0F && along <= 1.0F )
+					best = { wall, distance, along };
+			}
+			continue;
+		}
+
+		const int left = pending.node + 1;
+		const int right = node.first;
+
+		const float enter_left = enter_box( nodes[left].min, nodes[left].max, origin, inverse_dir, best.distance );
+		const float enter_right = enter_box( nodes[right].min, nodes[right].max, origin, inverse_dir, best.distance );
+
+		// push the far child first so the near one is visited first
+		const bool left_first = enter_left <= enter_right;
+		const Pending near = left_first ? Pending{ left, enter_left } : Pending{ right, enter_right };
+		const Pending far = left_first ? Pending{ right, enter_right } : Pending{ left, enter_left };
+
+		if( far.enter < best.distance )
+			stack[depth++] = far;
+		if( near.enter < best.distance )
+			stack[depth++] = near;
+	}
+
+	return best;
+}
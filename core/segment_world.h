@@ -0,0 +1,76 @@
+/*
+ * segment_world.h Copyright 2024 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#pragma once
+
+#include "grid.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+struct Segment {
+	glm::vec2 from;
+	glm::vec2 to;
+};
+
+struct SegmentHit {
+	int segment;	// index into segments(), -1 when the ray hit nothing
+	float distance; // along the ray
+	float along;	// 0 at from, 1 at to
+};
+
+/*
+ * Walls as arbitrary line segments, for levels that do not fit the grid. The segments are kept in a bounding
+ * volume hierarchy built once at load, so a ray only tests the few leaves along its path, nearest first, and
+ * stops as soon as no closer node is left.
+ */
+class SegmentWorld
+{
+public:
+	explicit SegmentWorld( std::vector<Segment> walls );
+
+	// one wall per line: x0 y0 x1 y1 in cells, lines starting with '#' are ignored
+	static SegmentWorld load( const std::string &path );
+
+	// the faces between wall and open cells, merged into runs
+	static SegmentWorld from_grid( const Grid &grid );
+
+	const std::vector<Segment> &segments() const { return walls; }
+
+	SegmentHit intersect( glm::vec2 origin, glm::vec2 direction ) const;
+
+private:
+	// depth first, the left child directly follows its parent
+	struct Node {
+		glm::vec2 min;
+		glm::vec2 max;
+		int32_t first; // leaf: first segment, inner: right child
+		int32_t count; // leaf: number of segments, inner: 0
+	};
+
+	static constexpr int leaf_size = 4;
+
+	int build( int first, int count );
+
+	std::vector<Segment> walls;
+	std::vector<Node> nodes;
+};
@@ -0,0 +1,40 @@
+/*
+ * shade.cc Copyright 2024 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#include "shade.h"
+
+#include <algorithm>
+
+// no early outs in the loop so the compiler can vectorise it
+void shade_columns( const HitBuffer &hits, float wall_scale, int screen_height, ColumnSpans &spans )
+{
+	const size_t columns = hits.size();
+	const int horizon = screen_height / 2;
+
+	spans.resize( columns );
+
+	for( size_t column = 0; column < columns; ++column ) {
+		const float distance = hits.distance[column];
+		const int height = ( distance > 0.0F ) ? static_cast<int>( wall_scale / distance ) : 0;
+
+		spans.top[column] = std::clamp( horizon - height, 0, screen_height );
+		spans.bottom[column] = std::clamp( horizon + height, 0, screen_height );
+		spans.shade[column] = static_cast<uint8_t>( hits.side[column] + 1 );
+	}
+}
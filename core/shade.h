@@ -0,0 +1,45 @@
+/*
+ * shade.h Copyright 2024 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#pragma once
+
+#include "hit_buffer.h"
+
+#include <cstdint>
+#include <vector>
+
+/*
+ * The shade stage output: the wall span of every screen column, rows [top, bottom), and which side of the
+ * wall it shows. Columns without a wall get an empty span at the horizon and a shade of 0.
+ */
+struct ColumnSpans {
+	std::vector<int> top;
+	std::vector<int> bottom;
+	std::vector<uint8_t> shade; // 0 no wall, 1 x side, 2 y side
+
+	void resize( size_t columns )
+	{
+		top.resize( columns );
+		bottom.resize( columns );
+		shade.resize( columns );
+	}
+};
+
+// wall_scale is the half height in pixels of a wall one cell away
+void shade_columns( const HitBuffer &hits, float wall_scale, int screen_height, ColumnSpans &spans );
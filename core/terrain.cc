@@ -0,0 +1,247 @@
+/*
+ * terrain.cc Copyright 2024 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#include "terrain.h"
+
+#include <algorithm>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+
+namespace
+{
+
+// reads a binary PGM (P5) or PPM (P6) with a maximum value of 255
+std::vector<uint8_t> read_pnm( const std::string &path, const std::string &magic, int channels, int &width,
+							   int &height )
+{
+	std::ifstream stream( path, std::ios::binary );
+	if( !stream )
+		throw std::runtime_error( "Cannot open " + path );
+
+	const auto next_token = [&]() {
+		std::string token;
+		while( stream >> token && token.front() == '#' )
+			stream.ignore( std::numeric_limits<std::streamsize>::max(), '\n' );
+		return token;
+	};
+
+	if( next_token() != magic )
+		throw std::runtime_error( path + ": not a " + magic + " file" );
+
+	width = std::stoi( next_token() );
+	height = std::stoi( next_token() );
+
+	if( std::stoi( next_token() ) != 255 )
+		throw std::runtime_error( path + ": only 8 bit images are supported" );
+
+	// exactly one whitespace byte separates the header from the pixels
+	stream.get();
+
+	std::vector<uint8_t> pixels( static_cast<size_t>( width ) * static_cast<size_t>( height ) * channels );
+	stream.read( reinterpret_cast<char *>( pixels.data() ), static_cast<std::streamsize>( pixels.size() ) );
+
+	if( !stream )
+		throw std::runtime_error( path + ": truncated" );
+
+	return pixels;
+}
+
+uint32_t hash( uint32_t x_pos, uint32_t y_pos, uint32_t seed )
+{
+	uint32_t value = x_pos * 0x8DA6B343U ^ y_pos * 0xD8163841U ^ seed * 0xCB1AB31FU;
+	value ^= value >> 13;
+	value *= 0x5BD1E995U;
+	return value ^ ( value >> 15 );
+}
+
+// smoothly interpolated lattice noise in [0, 1) with a lattice of period cells, so it tiles
+float value_noise( float x_pos, float y_pos, uint32_t period, uint32_t seed )
+{
+	const auto cell_x = static_cast<uint32_t>( x_pos );
+	const auto cell_y = static_cast<uint32_t>( y_pos );
+	const float fract_x = x_pos - static_cast<float>( cell_x );
+	const float fract_y = y_pos - static_cast<float>( cell_y );
+
+	const auto corner = [&]( uint32_t offset_x, uint32_t offset_y ) {
+		return static_cast<float>(
+				   hash( ( cell_x + offset_x ) % period, ( cell_y + offset_y ) % period, seed ) & 0xFFFFU ) /
+			   65536.0F;
+	};
+
+	const float smooth_x = fract_x * fract_x * ( 3.0F - 2.0F * fract_x );
+	const float smooth_y = fract_y * fract_y * ( 3.0F - 2.0F * fract_y );
+
+	const float top = corner( 0, 0 ) + ( corner( 1, 0 ) - corner( 0, 0 ) ) * smooth_x;
+	const float bottom = corner( 0, 1 ) + ( corner( 1, 1 ) - corner( 0, 1 ) ) * smooth_x;
+
+	return top + ( bottom - top ) * smooth_y;
+}
+
+} // namespace
+
+Terrain::Terrain( int size_log2, std::vector<TerrainSample> samples )
+	: size_log2( size_log2 ), mask( ( 1 << size_log2 ) - 1 ), samples( std::move( samples ) )
+{
+	if( this->samples.size() != static_cast<size_t>( 1 ) << ( 2 * size_log2 ) )
+		throw std::invalid_argument( "Terrain samples do not match its size" );
+}
+
+Terrain Terrain::load( const std::string &height_path, const std::string &colour_path )
+{
+	int width = 0;
+	int height = 0;
+	int colour_width = 0;
+	int colour_height = 0;
+
+	const std::vector<uint8_t> heights = read_pnm( height_path, "P5", 1, width, height );
+	const std::vector<uint8_t> colours = read_pnm( colour_path, "P6", 3, colour_width, colour_height );
+
+	if( width != height || ( width & ( width - 1 ) ) != 0 )
+		throw std::runtime_error( height_path + ": the height map must be a power of two square" );
+
+	if( colour_width != width || colour_height != height )
+		throw std::runtime_error( colour_path + ": the colour map must match the height map" );
+
+	std::vector<TerrainSample> samples( heights.size() );
+
+	for( size_t texel = 0; texel < samples.size(); ++texel )
+		samples[texel] = { heights[texel], colours[texel * 3], colours[texel * 3 + 1], colours[texel * 3 + 2] };
+
+	int size_log2 = 0;
+	while( ( 1 << size_log2 ) < width )
+		++size_log2;
+
+	return { size_log2, std::move( samples ) };
+}
+
+Terrain Terrain::generate( int size_log2, uint32_t seed )
+{
+	constexpr int octaves = 6;
+
+	const int size = 1 << size_log2;
+	const auto index = [&]( int x_pos, int y_pos ) {
+		return ( static_cast<size_t>( y_pos & ( size - 1 ) ) << size_log2 ) | static_cast<size_t>( x_pos & ( size - 1 ) );
+	};
+
+	std::vector<float> heights( static_cast<size_t>( size ) * static_cast<size_t>( size ) );
+
+	for( int y_pos = 0; y_pos < size; ++y_pos )
+		for( int x_pos = 0; x_pos < size; ++x_pos ) {
+			float height = 0.0F;
+			float amplitude = 0.5F;
+			auto period = static_cast<uint32_t>( 4 );
+
+			for( int octave = 0; octave < octaves && period <= static_cast<uint32_t>( size ); ++octave ) {
+				const float scale = static_cast<float>( period ) / static_cast<float>( size );
+				height += amplitude * value_noise( static_cast<float>( x_pos ) * scale,
+												   static_cast<float>( y_pos ) * scale, period, seed + octave );
+				amplitude *= 0.5F;
+				period *= 2;
+			}
+
+			heights[index( x_pos, y_pos )] = height;
+		}
+
+	const auto [lowest, highest] = std::minmax_element( heights.begin(), heights.end() );
+	const float range = std::max( *highest - *lowest, 0.0001F );
+
+	std::vector<TerrainSample> samples( heights.size() );
+
+	for( int y_pos = 0; y_pos < size; ++y_pos )
+		for( int x_pos = 0; x_pos < size; ++x_pos ) {
+			const float height = ( heights[index( x_pos, y_pos )] - *lowest ) / range;
+			const float slope = ( heights[index( x_pos, y_pos )] - heights[index( x_pos + 1, y_pos + 1 )] ) / range;
+			const float light = std::clamp( 1.0F + slope * 12.0F, 0.5F, 1.3F );
+
+			glm::vec3 colour = ( height < 0.3F )	? glm::vec3( 40.0F, 80.0F, 160.0F )
+							   : ( height < 0.35F ) ? glm::vec3( 200.0F, 190.0F, 130.0F )
+							   : ( height < 0.65F ) ? glm::vec3( 70.0F, 140.0F, 60.0F )
+							   : ( height < 0.85F ) ? glm::vec3( 120.0F, 110.0F, 100.0F )
+													: glm::vec3( 240.0F, 240.0F, 245.0F );
+			colour = colour * light;
+
+			// water stays flat
+			const float ground = std::max( height, 0.3F );
+
+			samples[index( x_pos, y_pos )] = { static_cast<uint8_t>( ground * 255.0F ),
+											   static_cast<uint8_t>( std::min( colour[0], 255.0F ) ),
+											   static_cast<uint8_t>( std::min( colour[1], 255.0F ) ),
+											   static_cast<uint8_t>( std::min( colour[2], 255.0F ) ) };
+		}
+
+	return { size_log2, std::move( samples ) };
+}
+
+void render_terrain_columns( const Terrain &terrain, const Camera &camera, const TerrainView &view,
+							 const Viewport &viewport, int first_column, int column_count, FrameBuffer &frame )
+{
+	const int height = viewport.height;
+
+	// columns are drawn into this column major scratch, then written to the frame a row at a time
+	thread_local std::vector<Pixel> strip;
+	strip.resize( static_cast<size_t>( column_count ) * static_cast<size_t>( height ) );
+
+	const float altitude = static_cast<float>( terrain.sample( camera.position ).height ) + view.eye_height;
+	const float horizon = view.horizon * static_cast<float>( height );
+	const float scale = view.height_scale * static_cast<float>( height );
+
+	const float first_angle = camera.angle - camera.half_fov();
+	const float delta_angle = 2.0F * camera.half_fov() / static_cast<float>( viewport.width );
+
+	for( int column = 0; column < column_count; ++column ) {
+		Pixel *pixels = strip.data() + static_cast<size_t>( column ) * static_cast<size_t>( height );
+
+		const float ray_angle = first_angle + delta_angle * static_cast<float>( first_column + column );
+		const glm::vec2 ray_dir = { std::cos( ray_angle ), std::sin( ray_angle ) };
+
+		// per unit along the ray, distance along the view direction, so the horizon stays straight
+		const float perpendicular = std::cos( ray_angle - camera.angle );
+
+		int y_buffer = height;
+		float distance = view.first_step;
+		float step = view.first_step;
+
+		while( distance < view.max_distance && y_buffer > 0 ) {
+			const TerrainSample &ground = terrain.sample( camera.position + ray_dir * distance );
+
+			const float row = horizon + ( altitude - static_cast<float>( ground.height ) ) * scale /
+											( distance * perpendicular );
+			const int top = std::max( 0, static_cast<int>( row ) );
+
+			if( top < y_buffer ) {
+				std::fill( pixels + top, pixels + y_buffer, make_pixel( ground.red, ground.green, ground.blue ) );
+				y_buffer = top;
+			}
+
+			// far away a texel covers less than a pixel, so sample ever more coarsely
+			distance += step;
+			step *= 1.0F + view.step_growth;
+		}
+
+		std::fill( pixels, pixels + y_buffer, view.sky );
+	}
+
+	for( int row = 0; row < height; ++row ) {
+		Pixel *target = frame.row( viewport.y + row ) + viewport.x + first_column;
+
+		for( int column = 0; column < column_count; ++column )
+			target[column] = strip[static_cast<size_t>( column ) * static_cast<size_t>( height ) + row];
+	}
+}
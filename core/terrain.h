@@ -0,0 +1,95 @@
+/*
+ * terrain.h Copyright 2024 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#pragma once
+
+#include "camera.h"
+#include "frame_buffer.h"
+
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+// height and colour side by side, so every step of a ray costs one four byte load
+struct TerrainSample {
+	uint8_t height;
+	uint8_t red;
+	uint8_t green;
+	uint8_t blue;
+};
+
+/*
+ * A square, power of two height map with a colour per texel. It wraps in both directions, so sampling is a mask
+ * instead of a bounds check. Positions are in texels.
+ */
+class Terrain
+{
+public:
+	Terrain( int size_log2, std::vector<TerrainSample> samples );
+
+	// an 8 bit PGM height map and a PPM colour map of the same power of two size
+	static Terrain load( const std::string &height_path, const std::string &colour_path );
+
+	// fractal hills, coloured by height and lit by slope
+	static Terrain generate( int size_log2, uint32_t seed );
+
+	int size() const { return 1 << size_log2; }
+
+	const TerrainSample &sample( glm::vec2 position ) const
+	{
+		const int x_pos = static_cast<int>( std::floor( position[0] ) ) & mask;
+		const int y_pos = static_cast<int>( std::floor( position[1] ) ) & mask;
+
+		return samples[( static_cast<size_t>( y_pos ) << size_log2 ) | static_cast<size_t>( x_pos )];
+	}
+
+private:
+	int size_log2;
+	int mask;
+	std::vector<TerrainSample> samples;
+};
+
+struct TerrainView {
+	float eye_height = 40.0F;	  // above the ground under the camera
+	float horizon = 0.35F;		  // as a fraction of the viewport height, from the top
+	float height_scale = 0.6F;	  // pixels per unit of height at unit distance, as a fraction of the viewport height
+	float max_distance = 600.0F;  // in texels
+	float first_step = 0.25F;	  // in texels
+	float step_growth = 0.01F;	  // each step is this much longer than the one before
+	Pixel sky = make_pixel( 135, 190, 235 );
+};
+
+// renders columns [first_column, first_column + column_count) of the view, front to back with a y-buffer per column
+void render_terrain_columns( const Terrain &terrain, const Camera &camera, const TerrainView &view,
+							 const Viewport &viewport, int first_column, int column_count, FrameBuffer &frame );
+
+inline void render_terrain( const Terrain &terrain, const Camera &camera, const TerrainView &view,
+							const Viewport &viewport, FrameBuffer &frame )
+{
+	render_terrain_columns( terrain, camera, view, viewport, 0, viewport.width, frame );
+}
+
+// the default view, for callers that treat every world alike
+inline void render_view( const Terrain &terrain, const Camera &camera, const Viewport &viewport, FrameBuffer &frame )
+{
+	render_terrain( terrain, camera, TerrainView{}, viewport, frame );
+}
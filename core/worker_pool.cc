@@ -0,0 +1,107 @@
+/*
+ * worker_pool.cc Copyright 2024 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#include "worker_pool.h"
+
+#include <algorithm>
+
+WorkerPool::WorkerPool( unsigned int thread_count )
+{
+	for( unsigned int worker = 1; worker < std::max( 1U, thread_count ); ++worker )
+		threads.emplace_back( [this]() { work(); } );
+}
+
+WorkerPool::~WorkerPool()
+{
+	{
+		const std::lock_guard<std::mutex> lock( mutex );
+		stopping = true;
+	}
+	wake.notify_all();
+
+	for( auto &thread : threads )
+		thread.join();
+}
+
+void WorkerPool::run( size_t task_count, const std::function<void( size_t )> &task )
+{
+	{
+		const std::lock_guard<std::mutex> lock( mutex );
+		job = &task;
+		job_size = task_count;
+		finished = 0;
+		next_task = 0;
+		++generation;
+	}
+	wake.notify_all();
+
+	const size_t completed = drain( task, task_count );
+
+	std::unique_lock<std::mutex> lock( mutex );
+	finished += completed;
+
+	// also wait for idle workers, a straggler must not pick up an index of the next job
+	done.wait( lock, [&]() { return finished == job_size && active == 0; } );
+
+	job = nullptr;
+	job_size = 0;
+}
+
+void WorkerPool::work()
+{
+	uint64_t seen = 0;
+
+	while( true ) {
+		const std::function<void( size_t )> *task = nullptr;
+		size_t task_count = 0;
+		{
+			std::unique_lock<std::mutex> lock( mutex );
+			wake.wait( lock, [&]() { return stopping || generation != seen; } );
+
+			if( stopping )
+				return;
+
+			seen = generation;
+			task = job;
+			task_count = job_size;
+			++active;
+		}
+
+		const size_t completed = ( task != nullptr ) ? drain( *task, task_count ) : 0;
+
+		{
+			const std::lock_guard<std::mutex> lock( mutex );
+			finished += completed;
+			--active;
+		}
+		done.notify_one();
+	}
+}
+
+size_t WorkerPool::drain( const std::function<void( size_t )> &task, size_t task_count )
+{
+	size_t completed = 0;
+
+	for( size_t index = next_task++; index < task_count; index = next_task++ ) {
+		task( index );
+		++completed;
+	}
+
+	return completed;
+}
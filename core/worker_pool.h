@@ -0,0 +1,70 @@
+/*
+ * worker_pool.h Copyright 2024 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*
+ * A fixed set of threads for fork-join work. run() hands out task indices one at a time, the calling thread
+ * takes part, and it returns once every task has finished.
+ */
+class WorkerPool
+{
+public:
+	explicit WorkerPool( unsigned int thread_count = std::thread::hardware_concurrency() );
+	~WorkerPool();
+
+	WorkerPool( const WorkerPool &other ) = delete;
+	WorkerPool( WorkerPool &&other ) = delete;
+	WorkerPool &operator=( const WorkerPool &other ) = delete;
+	WorkerPool &operator=( WorkerPool &&other ) = delete;
+
+	void run( size_t task_count, const std::function<void( size_t )> &task );
+
+	// including the calling thread
+	unsigned int size() const { return static_cast<unsigned int>( threads.size() ) + 1; }
+
+private:
+	void work();
+	size_t drain( const std::function<void( size_t )> &task, size_t task_count );
+
+	std::vector<std::thread> threads;
+
+	std::mutex mutex;
+	std::condition_variable wake;
+	std::condition_variable done;
+
+	// the current job, guarded by mutex
+	const std::function<void( size_t )> *job = nullptr;
+	size_t job_size = 0;
+	size_t finished = 0;
+	unsigned int active = 0;
+	uint64_t generation = 0;
+	bool stopping = false;
+
+	std::atomic<size_t> next_task = 0;
+};
@@ -0,0 +1,100 @@
+/*
+ * capture_format.h Copyright 2024 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+enum class CaptureFormat { raw, ppm, y4m };
+
+struct CaptureParams {
+	std::string path;
+	CaptureFormat format = CaptureFormat::ppm;
+	int frame_rate = 60;
+};
+
+inline CaptureFormat capture_format_from_path( const std::string &path )
+{
+	if( path.ends_with( ".y4m" ) )
+		return CaptureFormat::y4m;
+	if( path.ends_with( ".ppm" ) )
+		return CaptureFormat::ppm;
+
+	return CaptureFormat::raw;
+}
+
+/*
+ * Writes one frame of RGBA pixels as they come out of glReadPixels, so bottom row first, in the given format.
+ * Every format wants the rows top down. scratch is reused between frames to avoid an allocation per frame.
+ */
+inline void write_capture_frame( std::ostream &stream, CaptureFormat format, const uint8_t *pixels, int width,
+								 int height, std::vector<uint8_t> &scratch )
+{
+	const auto row_size = static_cast<size_t>( width ) * 4;
+	const auto row = [&]( int line ) { return pixels + static_cast<size_t>( height - 1 - line ) * row_size; };
+
+	switch( format ) {
+	case CaptureFormat::raw:
+		for( int line = 0; line < height; ++line )
+			stream.write( reinterpret_cast<const char *>( row( line ) ), static_cast<std::streamsize>( row_size ) );
+		break;
+
+	case CaptureFormat::ppm:
+		stream << "P6\n" << width << " " << height << "\n255\n";
+		scratch.resize( static_cast<size_t>( width ) * 3 );
+		for( int line = 0; line < height; ++line ) {
+			const uint8_t *source = row( line );
+			for( int column = 0; column < width; ++column )
+				for( const int channel : { 0, 1, 2 } )
+					scratch[column * 3 + channel] = source[column * 4 + channel];
+			stream.write( reinterpret_cast<const char *>( scratch.data() ),
+						  static_cast<std::streamsize>( scratch.size() ) );
+		}
+		break;
+
+	case CaptureFormat::y4m: {
+		const auto plane_size = static_cast<size_t>( width ) * height;
+		scratch.resize( plane_size * 3 );
+
+		// BT.601 studio swing, the default y4m readers assume
+		for( int line = 0; line < height; ++line ) {
+			const uint8_t *source = row( line );
+			for( int column = 0; column < width; ++column ) {
+				const int red = source[column * 4 + 0];
+				const int green = source[column * 4 + 1];
+				const int blue = source[column * 4 + 2];
+				const size_t offset = static_cast<size_t>( line ) * width + column;
+
+				scratch[offset] = static_cast<uint8_t>( ( ( 66 * red + 129 * green + 25 * blue + 128 ) >> 8 ) + 16 );
+				scratch[plane_size + offset] =
+					static_cast<uint8_t>( ( ( -38 * red - 74 * green + 112 * blue + 128 ) >> 8 ) + 128 );
+				scratch[2 * plane_size + offset] =
+					static_cast<uint8_t>( ( ( 112 * red - 94 * green - 18 * blue + 128 ) >> 8 ) + 128 );
+			}
+		}
+		stream << "FRAME\n";
+		stream.write( reinterpret_cast<const char *>( scratch.data() ), static_cast<std::streamsize>( scratch.size() ) );
+		break;
+	}
+	}
+}
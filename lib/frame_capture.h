@@ -0,0 +1,264 @@
+/*
+ * frame_capture.h Copyright 2024 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#pragma once
+
+#include "capture_format.h"
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#define GL_GLEXT_PROTOTYPES
+#include <SDL2/SDL_opengl.h>
+
+/*
+ * Streams the back buffer to disk without stalling the render loop.
+ *
+ * Each captured frame is read into one of a ring of pixel pack buffers, so glReadPixels only queues a transfer.
+ * Once its fence has signalled the buffer is mapped and the mapped pointer is handed to the writer thread, which
+ * formats and writes the pixels straight out of the mapping. The render thread never touches the pixel data. If
+ * every buffer is still in flight when a new frame arrives, that frame is dropped instead of waiting.
+ */
+class FrameCapture
+{
+public:
+	FrameCapture( CaptureParams params, int width, int height )
+		: params( std::move( params ) ), width( width ), height( height ),
+		  stream( this->params.path, std::ios::binary | std::ios::trunc )
+	{
+		if( !stream )
+			throw std::runtime_error( "Cannot open capture file " + this->params.path );
+
+		if( this->params.format == CaptureFormat::y4m )
+			stream << "YUV4MPEG2 W" << width << " H" << height << " F" << this->params.frame_rate
+				   << ":1 Ip A1:1 C444\n";
+
+		const auto frame_size = static_cast<GLsizeiptr>( width ) * height * 4;
+
+		for( auto &slot : slots ) {
+			glGenBuffers( 1, &slot.pbo );
+			glBindBuffer( GL_PIXEL_PACK_BUFFER, slot.pbo );
+			glBufferData( GL_PIXEL_PACK_BUFFER, frame_size, nullptr, GL_STREAM_READ );
+		}
+		glBindBuffer( GL_PIXEL_PACK_BUFFER, 0 );
+
+		writer = std::thread( [this]() { write_frames(); } );
+	}
+
+	~FrameCapture()
+	{
+		stop();
+
+		for( auto &slot : slots ) {
+			if( slot.state != SlotState::idle && slot.state != SlotState::reading ) {
+				glBindBuffer( GL_PIXEL_PACK_BUFFER, slot.pbo );
+				glUnmapBuffer( GL_PIXEL_PACK_BUFFER );
+			}
+			if( slot.fence != nullptr )
+				glDeleteSync( slot.fence );
+			glDeleteBuffers( 1, &slot.pbo );
+		}
+		glBindBuffer( GL_PIXEL_PACK_BUFFER, 0 );
+	}
+
+	FrameCapture( const FrameCapture &other ) = delete;
+	FrameCapture( FrameCapture &&other ) = delete;
+	FrameCapture &operator=( const FrameCapture &other ) = delete;
+	FrameCapture &operator=( FrameCapture &&other ) = delete;
+
+	// call after the frame is drawn and the renderer flushed, before it is presented. A frame whose drawable is
+	// not the size the capture was opened with is dropped, a cropped or padded frame would corrupt the stream
+	void capture_frame( int drawable_width, int drawable_height )
+	{
+		reclaim();
+
+		for( int count = 0; count < slot_count; ++count )
+			harvest( oldest_slot(), 0 );
+
+		if( drawable_width != width || drawable_height != height ) {
+			++dropped;
+			return;
+		}
+
+		Slot &slot = slots[next_slot];
+
+		if( slot.state != SlotState::idle ) {
+			++dropped;
+			return;
+		}
+
+		glBindBuffer( GL_PIXEL_PACK_BUFFER, slot.pbo );
+		glReadPixels( 0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, nullptr );
+		glBindBuffer( GL_PIXEL_PACK_BUFFER, 0 );
+
+		slot.fence = glFenceSync( GL_SYNC_GPU_COMMANDS_COMPLETE, 0 );
+		slot.sequence = submitted++;
+		slot.state = SlotState::reading;
+
+		next_slot = ( next_slot + 1 ) % slot_count;
+	}
+
+	// hand over whatever is still on the GPU, then let the writer drain its queue
+	void stop()
+	{
+		constexpr GLuint64 one_second = 1'000'000'000;
+
+		if( !writer.joinable() )
+			return;
+
+		for( int count = 0; count < slot_count; ++count )
+			harvest( oldest_slot(), one_second );
+
+		{
+			const std::lock_guard<std::mutex> lock( mutex );
+			stopping = true;
+		}
+		wake.notify_one();
+		writer.join();
+	}
+
+	uint64_t frames_written() const { return written; }
+	uint64_t frames_dropped() const { return dropped; }
+
+private:
+	enum class SlotState { idle, reading, mapped, written };
+
+	struct Slot {
+		GLuint pbo = 0;
+		GLsync fence = nullptr;
+		uint64_t sequence = 0;
+		const uint8_t *pixels = nullptr;
+		std::atomic<SlotState> state = SlotState::idle;
+	};
+
+	static constexpr int slot_count = 3;
+
+	// the reading slot submitted longest ago, so frames reach the writer in order
+	int oldest_slot() const
+	{
+		int oldest = next_slot;
+
+		for( int index = 0; index < slot_count; ++index )
+			if( slots[index].state == SlotState::reading && ( slots[oldest].state != SlotState::reading ||
+															  slots[index].sequence < slots[oldest].sequence ) )
+				oldest = index;
+
+		return oldest;
+	}
+
+	void reclaim()
+	{
+		for( auto &slot : slots ) {
+			if( slot.state != SlotState::written )
+				continue;
+
+			glBindBuffer( GL_PIXEL_PACK_BUFFER, slot.pbo );
+			glUnmapBuffer( GL_PIXEL_PACK_BUFFER );
+			slot.pixels = nullptr;
+			slot.state = SlotState::idle;
+		}
+		glBindBuffer( GL_PIXEL_PACK_BUFFER, 0 );
+	}
+
+	void harvest( int index, GLuint64 timeout )
+	{
+		Slot &slot = slots[index];
+
+		if( slot.state != SlotState::reading )
+			return;
+
+		const GLenum status = glClientWaitSync( slot.fence, GL_SYNC_FLUSH_COMMANDS_BIT, timeout );
+		if( status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED )
+			return;
+
+		glDeleteSync( slot.fence );
+		slot.fence = nullptr;
+
+		glBindBuffer( GL_PIXEL_PACK_BUFFER, slot.pbo );
+		slot.pixels = static_cast<const uint8_t *>(
+			glMapBufferRange( GL_PIXEL_PACK_BUFFER, 0, static_cast<GLsizeiptr>( width ) * height * 4, GL_MAP_READ_BIT ) );
+		glBindBuffer( GL_PIXEL_PACK_BUFFER, 0 );
+
+		if( slot.pixels == nullptr ) {
+			++dropped;
+			slot.state = SlotState::idle;
+			return;
+		}
+
+		slot.state = SlotState::mapped;
+		{
+			const std::lock_guard<std::mutex> lock( mutex );
+			queue.push_back( index );
+		}
+		wake.notify_one();
+	}
+
+	void write_frames()
+	{
+		while( true ) {
+			int index = 0;
+			{
+				std::unique_lock<std::mutex> lock( mutex );
+				wake.wait( lock, [this]() { return stopping || !queue.empty(); } );
+
+				if( queue.empty() )
+					return;
+
+				index = queue.front();
+				queue.pop_front();
+			}
+
+			write_capture_frame( stream, params.format, slots[index].pixels, width, height, scratch );
+			++written;
+
+			slots[index].state = SlotState::written;
+		}
+	}
+
+	CaptureParams params;
+	int width;
+	int height;
+
+	std::array<Slot, slot_count> slots;
+	int next_slot = 0;
+	uint64_t submitted = 0;
+
+	std::atomic<uint64_t> written = 0;
+	std::atomic<uint64_t> dropped = 0;
+
+	// owned by the writer thread
+	std::ofstream stream;
+	std::vector<uint8_t> scratch;
+
+	std::thread writer;
+	std::mutex mutex;
+	std::condition_variable wake;
+	std::deque<int> queue;
+	bool stopping = false;
+};
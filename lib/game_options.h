@@ -0,0 +1,73 @@
+/*
+ * game_options.h Copyright 2024 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#pragma once
+
+#include "capture_format.h"
+
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// the command line options every GameWrapper understands
+struct GameOptions {
+	CaptureParams capture;
+	std::string record_path;
+	std::string replay_path;
+
+	// whatever is left for the game itself, in order
+	std::vector<std::string> arguments;
+};
+
+constexpr const char *game_options_usage =
+	"[--capture <file.y4m|file.ppm|file.raw>] [--record <input.log> | --replay <input.log>]";
+
+// args is the whole argv, the program name is skipped. Throws std::invalid_argument for an option without its
+// value and for --record together with --replay, since a replay never writes a log
+inline GameOptions parse_game_options( std::span<char *> args )
+{
+	GameOptions options;
+
+	for( size_t arg = 1; arg < args.size(); ++arg ) {
+		const std::string option = args[arg];
+
+		if( option != "--capture" && option != "--record" && option != "--replay" ) {
+			options.arguments.push_back( option );
+			continue;
+		}
+
+		if( arg + 1 >= args.size() )
+			throw std::invalid_argument( option + " needs a file" );
+
+		const std::string path = args[++arg];
+
+		if( option == "--capture" )
+			options.capture = { path, capture_format_from_path( path ) };
+		else if( option == "--record" )
+			options.record_path = path;
+		else
+			options.replay_path = path;
+	}
+
+	if( !options.record_path.empty() && !options.replay_path.empty() )
+		throw std::invalid_argument( "--record and --replay cannot be combined" );
+
+	return options;
+}
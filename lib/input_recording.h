@@ -0,0 +1,122 @@
+/*
+ * input_recording.h Copyright 2024 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <fstream>
+#include <optional>
+#include <stdexcept>
+#include <string>
+
+/*
+ * Input log layout: the four byte magic "RCIN", a version byte, then one record per game tick. A record is the
+ * game's input state followed by the elapsed time in milliseconds, both as LEB128 varints, so a typical tick costs
+ * two bytes.
+ */
+namespace input_log
+{
+
+constexpr std::array<char, 4> magic = { 'R', 'C', 'I', 'N' };
+constexpr char version = 1;
+
+struct Tick {
+	uint32_t input_state;
+	uint64_t elapsed_time;
+};
+
+} // namespace input_log
+
+class InputRecorder
+{
+public:
+	explicit InputRecorder( const std::string &path ) : stream( path, std::ios::binary | std::ios::trunc )
+	{
+		if( !stream )
+			throw std::runtime_error( "Cannot create input log " + path );
+
+		stream.write( input_log::magic.data(), input_log::magic.size() );
+		stream.put( input_log::version );
+	}
+
+	void record( input_log::Tick tick )
+	{
+		write_varint( tick.input_state );
+		write_varint( tick.elapsed_time );
+	}
+
+private:
+	void write_varint( uint64_t value )
+	{
+		while( value >= 0x80 ) {
+			stream.put( static_cast<char>( ( value & 0x7F ) | 0x80 ) );
+			value >>= 7;
+		}
+		stream.put( static_cast<char>( value ) );
+	}
+
+	std::ofstream stream;
+};
+
+class InputReplayer
+{
+public:
+	explicit InputReplayer( const std::string &path ) : stream( path, std::ios::binary )
+	{
+		std::array<char, 4> header{};
+
+		stream.read( header.data(), header.size() );
+		if( !stream || header != input_log::magic || stream.get() != input_log::version )
+			throw std::runtime_error( "Not a version " + std::to_string( input_log::version ) + " input log: " + path );
+	}
+
+	// empty once the log is exhausted
+	std::optional<input_log::Tick> next()
+	{
+		const std::optional<uint64_t> input_state = read_varint();
+		const std::optional<uint64_t> elapsed_time = read_varint();
+
+		if( !input_state || !elapsed_time )
+			return std::nullopt;
+
+		return input_log::Tick{ static_cast<uint32_t>( *input_state ), *elapsed_time };
+	}
+
+private:
+	std::optional<uint64_t> read_varint()
+	{
+		uint64_t value = 0;
+
+		for( int shift = 0; shift < 64; shift += 7 ) {
+			const int byte = stream.get();
+			if( byte == std::char_traits<char>::eof() )
+				return std::nullopt;
+
+			value |= static_cast<uint64_t>( byte & 0x7F ) << shift;
+
+			if( ( byte & 0x80 ) == 0 )
+				return value;
+		}
+
+		return std::nullopt;
+	}
+
+	std::ifstream stream;
+};
@@ -20,7 +20,10 @@
 #pragma once
 
 #include <algorithm>
+#include <iostream>
+#include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #define GL_GLEXT_PROTOTYPES
@@ -31,6 +34,10 @@
 #include <glm/ext.hpp>
 #include <glm/glm.hpp>
 
+#include "frame_capture.h"
+#include "game_options.h"
+#include "input_recording.h"
+
 struct SetupParams {
 	std::string title;
 	int width;
@@ -45,6 +52,8 @@ public:
 	SDL_Wrapper() { SDL_Init( SDL_INIT_EVERYTHING ); }
 	~SDL_Wrapper()
 	{
+		if( texture != nullptr )
+			SDL_DestroyTexture( texture );
 		SDL_DestroyRenderer( renderer );
 		SDL_DestroyWindow( window );
 		SDL_Quit();
@@ -70,6 +79,15 @@ public:
 		glClear( GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT );
 	}
 
+	void flush_window() { SDL_RenderFlush( renderer ); }
+
+	// in pixels, which is not the window size on high DPI displays
+	std::pair<int, int> output_size()
+	{
+		std::pair<int, int> size{ 0, 0 };
+		SDL_GetRendererOutputSize( renderer, &size.first, &size.second );
+		return size;
+	}
 	void display_window() { SDL_RenderPresent( renderer ); }
 
 	void draw_point( glm::vec3 center, float radius, const glm::vec4 colour )
@@ -137,6 +155,21 @@ public:
 		draw_geometry( verts, colour );
 	}
 
+	// stretches a whole frame of 0xAARRGGBB pixels over the window
+	void draw_pixels( const uint32_t *pixels, int width, int height )
+	{
+		if( texture == nullptr || texture_size != glm::ivec2( width, height ) ) {
+			if( texture != nullptr )
+				SDL_DestroyTexture( texture );
+
+			texture = SDL_CreateTexture( renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STREAMING, width, height );
+			texture_size = glm::ivec2( width, height );
+		}
+
+		SDL_UpdateTexture( texture, nullptr, pixels, width * static_cast<int>( sizeof( uint32_t ) ) );
+		SDL_RenderCopy( renderer, texture, nullptr, nullptr );
+	}
+
 	void draw_geometry( std::vector<glm::vec4> &vertex_points, glm::vec4 color )
 	{
 		glm::u8vec3 temp = color * 255;
@@ -159,6 +192,9 @@ private:
 	SDL_Renderer *renderer = nullptr;
 	SDL_Window *window = nullptr;
 	SetupParams params;
+
+	SDL_Texture *texture = nullptr;
+	glm::ivec2 texture_size{ 0, 0 };
 };
 
 class Game
@@ -174,6 +210,8 @@ public:
 		setup();
 	}
 	bool input( SDL_Event &event ) { return process_event( event ); };
+	uint32_t input_state() { return get_input_state(); }
+	void restore_input( uint32_t state ) { set_input_state( state ); }
 	void update( uint64_t elapsed_time ) { update_state( elapsed_time ); }
 	void draw() { draw_frame(); }
 
@@ -184,6 +222,10 @@ protected:
 	virtual void update_state( uint64_t elapsed_time ) = 0;
 	virtual void draw_frame() = 0;
 
+	// everything update_state reads from the user, so a recorded run can be replayed exactly
+	virtual uint32_t get_input_state() { return 0; }
+	virtual void set_input_state( uint32_t /*unused*/ ) {}
+
 	void draw_point( glm::vec3 center, float radius, const glm::vec4 colour )
 	{
 		sdl_wrapper->draw_point( center, radius, colour );
@@ -200,6 +242,10 @@ protected:
 	{
 		sdl_wrapper->draw_rect( points, colour );
 	}
+	void draw_pixels( const uint32_t *pixels, int width, int height )
+	{
+		sdl_wrapper->draw_pixels( pixels, width, height );
+	}
 
 	SDL_Wrapper *sdl_wrapper = nullptr;
 };
@@ -215,13 +261,59 @@ public:
 	GameWrapper( GameWrapper &&other ) = delete;
 	GameWrapper &operator=( GameWrapper &other ) = delete;
 
+	// see parse_game_options
+	void set_options( const GameOptions &options )
+	{
+		capture_params = options.capture;
+		record_path = options.record_path;
+		replay_path = options.replay_path;
+	}
+
+	// for configuring the game before run()
+	T &game() { return aGame; }
+
 	int run()
 	{
 		SetupParams params = aGame.make_setup();
+
+		// a capture stream has one frame size, so the window may not change it
+		if( !capture_params.path.empty() )
+			params.flags &= ~static_cast<uint32_t>( SDL_WINDOW_RESIZABLE );
+
 		sdl_wrapper.create_window( params );
 
 		aGame.initialise( &sdl_wrapper );
 
+		if( !capture_params.path.empty() ) {
+			const auto [width, height] = sdl_wrapper.output_size();
+			capture = std::make_unique<FrameCapture>( capture_params, width, height );
+		}
+
+		if( replay_path.empty() )
+			run_live();
+		else
+			run_replay();
+
+		if( capture ) {
+			capture->stop();
+
+			std::clog << "Captured " << capture->frames_written() << " frames to " << capture_params.path << ", "
+					  << capture->frames_dropped() << " dropped\n";
+
+			capture.reset();
+		}
+
+		return 0;
+	};
+
+private:
+	void run_live()
+	{
+		std::unique_ptr<InputRecorder> recorder;
+
+		if( !record_path.empty() )
+			recorder = std::make_unique<InputRecorder>( record_path );
+
 		uint64_t game_tick = SDL_GetTicks64();
 
 		bool quit = false;
@@ -246,24 +338,70 @@ public:
 
 			if( SDL_GetTicks64() > ( game_tick + 16 ) ) {
 
-				aGame.update( SDL_GetTicks64() - game_tick );
-
-				sdl_wrapper.clear_window();
+				const uint64_t elapsed_time = SDL_GetTicks64() - game_tick;
 
-				aGame.draw();
+				if( recorder )
+					recorder->record( { aGame.input_state(), elapsed_time } );
 
-				sdl_wrapper.display_window();
+				render_frame( elapsed_time );
 
 				game_tick = SDL_GetTicks64();
 			}
 		}
+	}
 
-		return 0;
-	};
+	// feeds the logged input back on virtual time, as fast as the frames can be drawn
+	void run_replay()
+	{
+		InputReplayer replayer( replay_path );
+
+		while( true ) {
+
+			SDL_Event event;
+
+			while( SDL_PollEvent( &event ) ) {
+				if( event.type == SDL_QUIT )
+					return;
+
+				if( event.type == SDL_WINDOWEVENT && event.window.event == SDL_WINDOWEVENT_RESIZED )
+					glViewport( 0, 0, event.window.data1, event.window.data2 );
+			}
+
+			const std::optional<input_log::Tick> tick = replayer.next();
+			if( !tick )
+				return;
+
+			aGame.restore_input( tick->input_state );
+			render_frame( tick->elapsed_time );
+		}
+	}
+
+	void render_frame( uint64_t elapsed_time )
+	{
+		aGame.update( elapsed_time );
+
+		sdl_wrapper.clear_window();
+
+		aGame.draw();
+
+		if( capture ) {
+			sdl_wrapper.flush_window();
+
+			const auto [width, height] = sdl_wrapper.output_size();
+			capture->capture_frame( width, height );
+		}
+
+		sdl_wrapper.display_window();
+	}
 
-private:
 	SDL_Wrapper sdl_wrapper;
 	T aGame;
+
+	CaptureParams capture_params;
+	std::unique_ptr<FrameCapture> capture;
+
+	std::string record_path;
+	std::string replay_path;
 };
 
 class BlankGame : public Game
@@ -0,0 +1,215 @@
+/*
+ * batch_renderer.cc Copyright 2024 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#include "camera.h"
+#include "frame_buffer.h"
+#include "grid.h"
+#include "render_view.h"
+#include "segment_world.h"
+#include "terrain.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <span>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+namespace
+{
+
+// one pose per line: x y angle zoom, with the position in cells and the angle in degrees
+std::vector<Camera> load_poses( const std::string &path )
+{
+	std::ifstream stream( path );
+	if( !stream )
+		throw std::runtime_error( "Cannot open poses " + path );
+
+	std::vector<Camera> poses;
+	std::string line;
+	int line_number = 0;
+
+	while( std::getline( stream, line ) ) {
+		++line_number;
+
+		if( line.find_first_not_of( " \t\r" ) == std::string::npos || line.front() == '#' )
+			continue;
+
+		std::istringstream fields( line );
+		float x_pos = 0.0F;
+		float y_pos = 0.0F;
+		float angle = 0.0F;
+		float zoom = 0.0F;
+
+		if( !( fields >> x_pos >> y_pos >> angle >> zoom ) )
+			throw std::runtime_error( path + ":" + std::to_string( line_number ) + ": expected x y angle zoom" );
+
+		poses.push_back( { { x_pos, y_pos }, glm::radians( angle ), zoom } );
+	}
+
+	return poses;
+}
+
+void write_ppm( const FrameBuffer &frame, std::vector<uint8_t> &rgb, const std::filesystem::path &path )
+{
+	std::ofstream stream( path, std::ios::binary | std::ios::trunc );
+	if( !stream )
+		throw std::runtime_error( "Cannot create " + path.string() );
+
+	rgb.resize( frame.pixels.size() * 3 );
+
+	uint8_t *channel = rgb.data();
+	for( const Pixel pixel : frame.pixels ) {
+		*channel++ = static_cast<uint8_t>( pixel >> 16 );
+		*channel++ = static_cast<uint8_t>( pixel >> 8 );
+		*channel++ = static_cast<uint8_t>( pixel );
+	}
+
+	stream << "P6\n" << frame.width << " " << frame.height << "\n255\n";
+	stream.write( reinterpret_cast<const char *>( rgb.data() ), static_cast<std::streamsize>( rgb.size() ) );
+}
+
+struct BatchParams {
+	std::vector<Camera> poses;
+	std::filesystem::path output_dir;
+	int width;
+	int height;
+	unsigned int thread_count;
+};
+
+// poses are handed out one at a time, the world is shared read-only by every worker. Only the rendering is
+// timed, loading the world is not
+template <typename World> bool render_batch( const World &world, const BatchParams &params )
+{
+	const auto start = std::chrono::steady_clock::now();
+
+	std::atomic<size_t> next_pose = 0;
+	std::atomic<bool> failed = false;
+	std::vector<std::thread> workers;
+
+	for( unsigned int worker = 0; worker < params.thread_count; ++worker )
+		workers.emplace_back( [&]() {
+			FrameBuffer frame( params.width, params.height );
+			std::vector<uint8_t> rgb;
+
+			for( size_t pose = next_pose++; pose < params.poses.size() && !failed; pose = next_pose++ ) {
+				std::ostringstream name;
+				name << "pose_" << std::setw( 5 ) << std::setfill( '0' ) << pose << ".ppm";
+
+				render_view( world, params.poses[pose], { 0, 0, params.width, params.height }, frame );
+
+				try {
+					write_ppm( frame, rgb, params.output_dir / name.str() );
+				} catch( const std::exception &error ) {
+					std::cerr << error.what() << '\n';
+					failed = true;
+				}
+			}
+		} );
+
+	for( auto &worker : workers )
+		worker.join();
+
+	if( failed )
+		return false;
+
+	const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+	std::clog << "Rendered " << params.poses.size() << " poses on " << params.thread_count << " threads in "
+			  << elapsed.count() << " s\n";
+
+	return true;
+}
+
+int usage( const char *program )
+{
+	std::cerr << "usage: " << program << " <level> <poses> <output directory> [--size <width>x<height>] [--threads <n>]\n"
+			  << "  a level ending in .segments holds one 'x0 y0 x1 y1' wall per line, anything else is a grid\n"
+			  << "  a level ending in .pgm is a height map, its colours are read from the .ppm of the same name\n"
+			  << "  poses holds one 'x y angle zoom' per line, angle in degrees, position in cells\n"
+			  << "  (texels for a height map)\n"
+			  << "  terrain is seen from " << TerrainView{}.eye_height << " above the ground under the camera\n";
+	return 1;
+}
+
+} // namespace
+
+int main( int argc, char *argv[] )
+{
+	const std::span<char *> args( argv, argc );
+
+	if( args.size() < 4 )
+		return usage( args[0] );
+
+	int width = 640;
+	int height = 480;
+	unsigned int thread_count = std::max( 1U, std::thread::hardware_concurrency() );
+
+	for( size_t arg = 4; arg < args.size(); arg += 2 ) {
+		const std::string option = args[arg];
+
+		if( option == "--size" && arg + 1 < args.size() ) {
+			char separator = 0;
+			std::istringstream size( args[arg + 1] );
+			if( !( size >> width >> separator >> height ) || separator != 'x' || width <= 0 || height <= 0 )
+				return usage( args[0] );
+		} else if( option == "--threads" && arg + 1 < args.size() )
+			thread_count = std::max( 1, std::atoi( args[arg + 1] ) );
+		else
+			return usage( args[0] );
+	}
+
+	try {
+		const std::string level_path = args[1];
+		const BatchParams params{ load_poses( args[2] ), args[3], width, height, thread_count };
+
+		std::filesystem::create_directories( params.output_dir );
+
+		bool rendered = false;
+
+		if( level_path.ends_with( ".segments" ) )
+			rendered = render_batch( SegmentWorld::load( level_path ), params );
+		else if( level_path.ends_with( ".pgm" ) )
+			rendered = render_batch(
+				Terrain::load( level_path, std::filesystem::path( level_path ).replace_extension( ".ppm" ).string() ),
+				params );
+		else
+			rendered = render_batch( Grid::load( level_path ), params );
+
+		if( !rendered )
+			return 1;
+
+	} catch( const std::exception &error ) {
+		std::cerr << error.what() << '\n';
+		return 1;
+	}
+
+	return 0;
+}
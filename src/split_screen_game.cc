@@ -0,0 +1,151 @@
+/*
+ * split_screen_game.cc Copyright 2024 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#include "split_screen_game.h"
+
+#include "render_view.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <span>
+#include <stdexcept>
+
+int main( int argc, char *argv[] )
+{
+	GameWrapper<SplitScreenGame> the_game;
+
+	const std::span<char *> args( argv, argc );
+
+	try {
+		const GameOptions options = parse_game_options( args );
+		if( !options.arguments.empty() )
+			throw std::invalid_argument( "Unknown option " + options.arguments.front() );
+
+		the_game.set_options( options );
+	} catch( const std::invalid_argument &error ) {
+		std::cerr << error.what() << '\n' << "usage: " << args[0] << " " << game_options_usage << '\n';
+		return 1;
+	}
+
+	try {
+		return the_game.run();
+	} catch( const std::exception &error ) {
+		std::cerr << error.what() << '\n';
+		return 1;
+	}
+}
+
+SetupParams SplitScreenGame::get_params()
+{
+	return SetupParams( { "Split Screen", screen_width, screen_height, SDL_WINDOW_OPENGL | SDL_WINDOW_RESIZABLE,
+						  SDL_RENDERER_ACCELERATED } );
+}
+
+void SplitScreenGame::setup()
+{
+	cameras = { { { 2.0F, 2.0F }, 0.0F, 0.4F },
+				{ { 8.5F, 1.5F }, glm::radians( 135.0F ), 0.6F },
+				{ { 1.5F, 8.5F }, glm::radians( -45.0F ), 0.6F },
+				{ { 8.5F, 8.5F }, glm::radians( -135.0F ), 0.6F } };
+
+	cameras.resize( view_count, cameras.back() );
+
+	for( size_t view = 1; view < cameras.size(); ++view )
+		security_cameras.push_back( { cameras[view].angle, glm::radians( 30.0F ) } );
+
+	viewports = tile_viewports( view_count, screen_width, screen_height );
+
+	for( int view = 0; view < view_count; ++view )
+		for( int column = 0; column < viewports[view].width; column += strip_width )
+			strips.push_back( { view, column, std::min( strip_width, viewports[view].width - column ) } );
+}
+
+bool SplitScreenGame::process_event( SDL_Event &event )
+{
+	if( event.type == SDL_KEYDOWN ) {
+		switch( event.key.keysym.sym ) {
+		case SDLK_UP: key_state |= 1 << KEY_UP; break;
+		case SDLK_DOWN: key_state |= 1 << KEY_DOWN; break;
+		case SDLK_LEFT: key_state |= 1 << KEY_LEFT; break;
+		case SDLK_RIGHT: key_state |= 1 << KEY_RIGHT; break;
+		}
+	}
+
+	if( event.type == SDL_KEYUP ) {
+		switch( event.key.keysym.sym ) {
+		case SDLK_UP: key_state &= ~( 1 << KEY_UP ); break;
+		case SDLK_DOWN: key_state &= ~( 1 << KEY_DOWN ); break;
+		case SDLK_LEFT: key_state &= ~( 1 << KEY_LEFT ); break;
+		case SDLK_RIGHT: key_state &= ~( 1 << KEY_RIGHT ); break;
+		case SDLK_ESCAPE: quit = true; break;
+		}
+	}
+
+	if( event.type == SDL_QUIT )
+		quit = true;
+
+	return quit;
+}
+
+void SplitScreenGame::update_state( uint64_t elapsed_time )
+{
+	auto elapsed_time_f = static_cast<float>( elapsed_time );
+	Camera &player = cameras.front();
+
+	float speed = 0.0F;
+
+	if( ( key_state & ( 1 << KEY_UP ) ) != 0 )
+		speed += 0.005F;
+	if( ( key_state & ( 1 << KEY_DOWN ) ) != 0 )
+		speed -= 0.005F;
+
+	const glm::vec2 new_position = player.position + player.direction() * ( speed * elapsed_time_f );
+
+	if( !level.is_wall( glm::ivec2( new_position ) ) )
+		player.position = new_position;
+
+	if( ( key_state & ( 1 << KEY_LEFT ) ) != 0 )
+		player.angle -= glm::radians( 0.1F * elapsed_time_f );
+	if( ( key_state & ( 1 << KEY_RIGHT ) ) != 0 )
+		player.angle += glm::radians( 0.1F * elapsed_time_f );
+
+	// virtual time only, so recorded runs replay the same sweep
+	clock += elapsed_time;
+
+	const float phase = static_cast<float>( clock ) / 1000.0F;
+
+	for( size_t security = 0; security < security_cameras.size(); ++security )
+		cameras[security + 1].angle =
+			security_cameras[security].centre_angle +
+			security_cameras[security].sweep * std::sin( phase + static_cast<float>( security ) );
+}
+
+void SplitScreenGame::draw_frame()
+{
+	// the grid and the cameras are only read while the strips render
+	workers.run( strips.size(), [this]( size_t index ) {
+		const Strip &strip = strips[index];
+
+		render_view_columns( level, cameras[strip.view], viewports[strip.view], strip.first_column,
+							 strip.column_count, frame );
+	} );
+
+	draw_pixels( frame.pixels.data(), frame.width, frame.height );
+}
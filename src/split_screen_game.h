@@ -0,0 +1,95 @@
+/*
+ * split_screen_game.h Copyright 2024 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#pragma once
+
+#include "camera.h"
+#include "frame_buffer.h"
+#include "grid.h"
+#include "sdl2wrapper.h"
+#include "worker_pool.h"
+
+#include <vector>
+
+#include <glm/glm.hpp>
+
+/*
+ * Several cameras on one grid, each in its own viewport. The first one is steered with the arrow keys, the
+ * others are security cameras sweeping back and forth. All viewports are cut into column strips that the
+ * worker pool renders in parallel, so the cost follows the pixel count, not the number of views.
+ */
+class SplitScreenGame : public Game
+{
+private:
+	SetupParams get_params() override;
+	void setup() override;
+	bool process_event( SDL_Event &event ) override;
+	void update_state( uint64_t elapsed_time ) override;
+	void draw_frame() override;
+	uint32_t get_input_state() override { return key_state; }
+	void set_input_state( uint32_t state ) override { key_state = static_cast<uint8_t>( state ); }
+
+	struct Strip {
+		int view;
+		int first_column;
+		int column_count;
+	};
+
+	struct SecurityCamera {
+		float centre_angle;
+		float sweep;
+	};
+
+	Grid level{ { 10, 10 },
+				"1111111111"
+				"1000100001"
+				"1000100001"
+				"1000100001"
+				"1000000001"
+				"1000000001"
+				"1000000001"
+				"1000001001"
+				"1000000001"
+				"1111011111" };
+
+	const int screen_width = 640;
+	const int screen_height = 480;
+	const int view_count = 4;
+
+	static constexpr int strip_width = 16;
+
+	bool quit = false;
+
+	uint8_t KEY_UP = 0;
+	uint8_t KEY_DOWN = 1;
+	uint8_t KEY_LEFT = 2;
+	uint8_t KEY_RIGHT = 3;
+
+	uint8_t key_state = 0;
+
+	std::vector<Camera> cameras;
+	std::vector<SecurityCamera> security_cameras;
+	uint64_t clock = 0;
+
+	FrameBuffer frame{ screen_width, screen_height };
+	std::vector<Viewport> viewports;
+	std::vector<Strip> strips;
+
+	WorkerPool workers;
+};
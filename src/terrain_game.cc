@@ -0,0 +1,144 @@
+/*
+ * terrain_game.cc Copyright 2024 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#include "terrain_game.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <span>
+#include <stdexcept>
+#include <string>
+
+int main( int argc, char *argv[] )
+{
+	GameWrapper<TerrainGame> the_game;
+
+	const std::span<char *> args( argv, argc );
+
+	const auto usage = [&]() {
+		std::cerr << "usage: " << args[0] << " [<height.pgm> <colour.ppm>] " << game_options_usage << '\n';
+		return 1;
+	};
+
+	GameOptions options;
+
+	try {
+		options = parse_game_options( args );
+	} catch( const std::invalid_argument &error ) {
+		std::cerr << error.what() << '\n';
+		return usage();
+	}
+
+	if( !options.arguments.empty() && options.arguments.size() != 2 )
+		return usage();
+
+	the_game.set_options( options );
+
+	try {
+		if( options.arguments.size() == 2 )
+			the_game.game().set_terrain( Terrain::load( options.arguments[0], options.arguments[1] ) );
+
+		return the_game.run();
+	} catch( const std::exception &error ) {
+		std::cerr << error.what() << '\n';
+		return 1;
+	}
+}
+
+SetupParams TerrainGame::get_params()
+{
+	return SetupParams( { "Terrain Caster", screen_width, screen_height, SDL_WINDOW_OPENGL | SDL_WINDOW_RESIZABLE,
+						  SDL_RENDERER_ACCELERATED } );
+}
+
+void TerrainGame::setup()
+{
+	if( !terrain )
+		terrain = Terrain::generate( 10, 1 );
+
+	camera.position = glm::vec2( static_cast<float>( terrain->size() ) / 2.0F );
+}
+
+bool TerrainGame::process_event( SDL_Event &event )
+{
+	if( event.type == SDL_KEYDOWN ) {
+		switch( event.key.keysym.sym ) {
+		case SDLK_UP: key_state |= 1 << KEY_UP; break;
+		case SDLK_DOWN: key_state |= 1 << KEY_DOWN; break;
+		case SDLK_LEFT: key_state |= 1 << KEY_LEFT; break;
+		case SDLK_RIGHT: key_state |= 1 << KEY_RIGHT; break;
+		case SDLK_x: key_state |= 1 << KEY_X; break;
+		case SDLK_z: key_state |= 1 << KEY_Z; break;
+		}
+	}
+
+	if( event.type == SDL_KEYUP ) {
+		switch( event.key.keysym.sym ) {
+		case SDLK_UP: key_state &= ~( 1 << KEY_UP ); break;
+		case SDLK_DOWN: key_state &= ~( 1 << KEY_DOWN ); break;
+		case SDLK_LEFT: key_state &= ~( 1 << KEY_LEFT ); break;
+		case SDLK_RIGHT: key_state &= ~( 1 << KEY_RIGHT ); break;
+		case SDLK_x: key_state &= ~( 1 << KEY_X ); break;
+		case SDLK_z: key_state &= ~( 1 << KEY_Z ); break;
+		case SDLK_ESCAPE: quit = true; break;
+		}
+	}
+
+	if( event.type == SDL_QUIT )
+		quit = true;
+
+	return quit;
+}
+
+void TerrainGame::update_state( uint64_t elapsed_time )
+{
+	auto elapsed_time_f = static_cast<float>( elapsed_time );
+
+	// the terrain wraps, so there is nothing to bump into
+	if( ( key_state & ( 1 << KEY_UP ) ) != 0 )
+		camera.position += camera.direction() * ( 0.1F * elapsed_time_f );
+	if( ( key_state & ( 1 << KEY_DOWN ) ) != 0 )
+		camera.position -= camera.direction() * ( 0.1F * elapsed_time_f );
+
+	if( ( key_state & ( 1 << KEY_LEFT ) ) != 0 )
+		camera.angle -= glm::radians( 0.1F * elapsed_time_f );
+	if( ( key_state & ( 1 << KEY_RIGHT ) ) != 0 )
+		camera.angle += glm::radians( 0.1F * elapsed_time_f );
+
+	if( ( key_state & ( 1 << KEY_Z ) ) != 0 )
+		view.eye_height += 0.1F * elapsed_time_f;
+	if( ( key_state & ( 1 << KEY_X ) ) != 0 )
+		view.eye_height = std::max( 1.0F, view.eye_height - 0.1F * elapsed_time_f );
+}
+
+void TerrainGame::draw_frame()
+{
+	const Viewport viewport{ 0, 0, screen_width, screen_height };
+	const auto strip_count = static_cast<size_t>( ( screen_width + strip_width - 1 ) / strip_width );
+
+	workers.run( strip_count, [&]( size_t strip ) {
+		const int first_column = static_cast<int>( strip ) * strip_width;
+
+		render_terrain_columns( *terrain, camera, view, viewport, first_column,
+								std::min( strip_width, screen_width - first_column ), frame );
+	} );
+
+	draw_pixels( frame.pixels.data(), frame.width, frame.height );
+}
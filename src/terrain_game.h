@@ -0,0 +1,71 @@
+/*
+ * terrain_game.h Copyright 2024 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#pragma once
+
+#include "camera.h"
+#include "frame_buffer.h"
+#include "sdl2wrapper.h"
+#include "terrain.h"
+#include "worker_pool.h"
+
+#include <optional>
+#include <vector>
+
+/*
+ * Flies a camera over a height field. The arrow keys move and turn, z and x raise and lower the eye. The view is
+ * cut into column strips for the worker pool, the same way the split screen does it.
+ */
+class TerrainGame : public Game
+{
+public:
+	void set_terrain( Terrain new_terrain ) { terrain = std::move( new_terrain ); }
+
+private:
+	SetupParams get_params() override;
+	void setup() override;
+	bool process_event( SDL_Event &event ) override;
+	void update_state( uint64_t elapsed_time ) override;
+	void draw_frame() override;
+	uint32_t get_input_state() override { return key_state; }
+	void set_input_state( uint32_t state ) override { key_state = static_cast<uint8_t>( state ); }
+
+	const int screen_width = 640;
+	const int screen_height = 480;
+
+	static constexpr int strip_width = 16;
+
+	bool quit = false;
+
+	uint8_t KEY_UP = 0;
+	uint8_t KEY_DOWN = 1;
+	uint8_t KEY_LEFT = 2;
+	uint8_t KEY_RIGHT = 3;
+	uint8_t KEY_X = 4;
+	uint8_t KEY_Z = 5;
+
+	uint8_t key_state = 0;
+
+	std::optional<Terrain> terrain;
+	Camera camera{ { 0.0F, 0.0F }, 0.0F, 0.6F };
+	TerrainView view;
+
+	FrameBuffer frame{ screen_width, screen_height };
+	WorkerPool workers;
+};
@@ -27,10 +27,53 @@
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
-int main( int /*unused*/, char ** /*unused*/ )
+#include <array>
+#include <iostream>
+#include <span>
+
+int main( int argc, char *argv[] )
 {
 	GameWrapper<TilePaintingGame> the_game;
-	return the_game.run();
+
+	const std::span<char *> args( argv, argc );
+
+	const auto usage = [&]() {
+		std::cerr << "usage: " << args[0] << " [--level <file.map>] " << game_options_usage << '\n'
+				  << "  --level cannot be combined with --record or --replay\n";
+		return 1;
+	};
+
+	GameOptions options;
+
+	try {
+		options = parse_game_options( args );
+	} catch( const std::invalid_argument &error ) {
+		std::cerr << error.what() << '\n';
+		return usage();
+	}
+
+	std::string level_path;
+
+	for( size_t arg = 0; arg < options.arguments.size(); arg += 2 ) {
+		if( options.arguments[arg] != "--level" || arg + 1 >= options.arguments.size() )
+			return usage();
+
+		level_path = options.arguments[arg + 1];
+	}
+
+	// level reloads are not in the input log, a run that picked one up would not replay the same
+	if( !level_path.empty() && ( !options.record_path.empty() || !options.replay_path.empty() ) )
+		return usage();
+
+	the_game.set_options( options );
+	the_game.game().set_level_path( level_path );
+
+	try {
+		return the_game.run();
+	} catch( const std::exception &error ) {
+		std::cerr << error.what() << '\n';
+		return 1;
+	}
 }
 
 SetupParams TilePaintingGame::get_params()
@@ -39,6 +82,19 @@ SetupParams TilePaintingGame::get_params()
 						  SDL_RENDERER_ACCELERATED } );
 }
 
+void TilePaintingGame::setup()
+{
+	if( !level_path.empty() ) {
+		level = Grid::load( level_path );
+		level_watcher.emplace( level_path, level );
+	}
+
+	build_minimap( { { 0, 0 }, level.dimension() } );
+
+	// the first tick moves along this matrix, so it has to be valid before then
+	update_player_matrix();
+}
+
 bool TilePaintingGame::process_event( SDL_Event &event )
 {
 	if( event.type == SDL_KEYDOWN ) {
@@ -74,19 +130,21 @@ void TilePaintingGame::update_state( uint64_t elapsed_time )
 {
 	auto elapsed_time_f = static_cast<float>( elapsed_time );
 
+	reload_level();
+
 	if( ( key_state & ( 1 << KEY_UP ) ) != 0 ) {
 		const glm::vec3 new_position = player_matrix * glm::vec4( 0.005F * elapsed_time_f, 0.0F, 0.0F, 1.0F );
 
-		if( !is_wall( glm::ivec2( new_position[0] / static_cast<float>( unit_size ),
-								  new_position[1] / static_cast<float>( unit_size ) ) ) )
+		if( !level.is_wall( glm::ivec2( new_position[0] / static_cast<float>( unit_size ),
+										new_position[1] / static_cast<float>( unit_size ) ) ) )
 			player_position = new_position;
 	}
 
 	if( ( key_state & ( 1 << KEY_DOWN ) ) != 0 ) {
 		const glm::vec3 new_position = player_matrix * glm::vec4( -0.005F * elapsed_time_f, 0.0F, 0.0F, 1.0F );
 
-		if( !is_wall( glm::ivec2( new_position[0] / static_cast<float>( unit_size ),
-								  new_position[1] / static_cast<float>( unit_size ) ) ) )
+		if( !level.is_wall( glm::ivec2( new_position[0] / static_cast<float>( unit_size ),
+										new_position[1] / static_cast<float>( unit_size ) ) ) )
 			player_position = new_position;
 	}
 
@@ -100,6 +158,11 @@ void TilePaintingGame::update_state( uint64_t elapsed_time )
 	if( ( key_state & ( 1 << KEY_Z ) ) != 0 )
 		player_zoom += 0.001F * elapsed_time_f;
 
+	update_player_matrix();
+}
+
+void TilePaintingGame::update_player_matrix()
+{
 	player_matrix = glm::mat4( {
 		{ unit_size * std::cos( player_angle ), unit_size * std::sin( player_angle ), 0.0F, 0.0F },
 		{ -unit_size * std::sin( player_angle ), unit_size * std::cos( player_angle ), 0.0F, 0.0F },
@@ -110,15 +173,24 @@ void TilePaintingGame::update_state( uint64_t elapsed_time )
 
 void TilePaintingGame::draw_frame()
 {
+	perf_counters.begin( perf_phases[0] );
+	cast_walls();
+	perf_counters.end( perf_phases[0] );
+
 	paint_floor();
 	paint_ceiling();
-	paint_rays();
+
+	perf_counters.begin( perf_phases[1] );
+	paint_walls();
+	perf_counters.end( perf_phases[1] );
 
 	// minimap
 	paint_grid();
 	paint_level();
 	paint_camera();
 	paint_character();
+
+	perf_counters.end_frame( perf_phases, ray_hits.size(), "ray" );
 }
 
 void TilePaintingGame::paint_floor()
@@ -143,48 +215,32 @@ void TilePaintingGame::paint_ceiling()
 	draw_rect( points, blue );
 }
 
-void TilePaintingGame::paint_rays()
+// cast stage, traversal only
+void TilePaintingGame::cast_walls()
 {
-	constexpr int x_dim = 0;
-	constexpr int y_dim = 1;
+	const Camera camera{ glm::vec2( player_position ) / unit_size, player_angle, player_zoom };
 
-	constexpr glm::vec4 dark_grey = glm::vec4( 0.75F, 0.75F, 0.75F, 1.0F );
-	constexpr glm::vec4 light_grey = glm::vec4( 0.5F, 0.5F, 0.5F, 1.0F );
-	constexpr glm::vec4 black = glm::vec4( 0.0F, 0.0F, 0.0F, 1.0F );
+	cast_rays( level, camera, ray_hits );
+}
 
-	auto resolution = static_cast<float>( screen_width );
+// shade stage, turns the hit buffer into spans and draws them
+void TilePaintingGame::paint_walls()
+{
+	constexpr std::array<glm::vec4, 3> shades = { glm::vec4( 0.0F, 0.0F, 0.0F, 1.0F ),
+												  glm::vec4( 0.5F, 0.5F, 0.5F, 1.0F ),
+												  glm::vec4( 0.75F, 0.75F, 0.75F, 1.0F ) };
 
-	float rot_angle = player_angle - std::atan( player_zoom );
-	const float delta_angle = 2.0F * std::atan( player_zoom ) / resolution;
+	shade_columns( ray_hits, 400.0F, screen_height, wall_spans );
 
 	for( int step = 0; step <= screen_width; ++step ) {
 
-		const glm::vec2 ray_start = glm::vec2( player_position ) / unit_size;
-
-		auto [wall_side, hit_point] = calc_intersection( rot_angle, ray_start );
-
-		if( wall_side != -1 ) {
-
-			const glm::vec2 intersection( hit_point * unit_size );
-
-			glm::vec2 delta = intersection - glm::vec2( player_position );
+		if( wall_spans.shade[step] == 0 )
+			continue;
 
-			// credit: https://www.youtube.com/watch?v=eOCQfxRQ2pY
-			const float distance = delta[x_dim] * std::cos( player_angle ) + delta[y_dim] * std::sin( player_angle );
-
-			const float height = unit_size * 400.0F / distance;
-			const std::pair<glm::vec3, glm::vec3> points = { glm::vec3( step, ( screen_height / 2.0 ) - height, 0 ),
-															 glm::vec3( step, ( screen_height / 2.0 ) + height, 0 ) };
-
-			const float horz_offset = ( 1.0F * intersection[x_dim] ) / unit_size;
-
-			if( horz_offset < .0 )
-				draw_line( points, black );
-			else
-				draw_line( points, ( wall_side == x_dim ) ? light_grey : dark_grey );
-		}
+		const std::pair<glm::vec3, glm::vec3> points = { glm::vec3( step, wall_spans.top[step], 0 ),
+														 glm::vec3( step, wall_spans.bottom[step], 0 ) };
 
-		rot_angle += delta_angle;
+		draw_line( points, shades[wall_spans.shade[step]] );
 	}
 }
 
@@ -192,6 +248,8 @@ void TilePaintingGame::paint_grid()
 {
 	constexpr glm::vec4 grid_color = { 0.3, 0.3, 0.3, 1.0 };
 
+	const glm::ivec2 world_dimension = level.dimension();
+
 	for( unsigned int line = 0; line <= world_dimension[0]; ++line )
 		draw_line(
 			{ { static_cast<float>( line ) * unit_size, 0, 0 },
@@ -205,21 +263,65 @@ void TilePaintingGame::paint_grid()
 			grid_color );
 }
 
+// parsing and diffing happened on the watcher thread, this only copies the changed cells and redoes their rows
+void TilePaintingGame::reload_level()
+{
+	if( !level_watcher )
+		return;
+
+	std::optional<GridPatch> patch = level_watcher->poll();
+	if( !patch )
+		return;
+
+	const GridRegion changed = patch->region;
+
+	level.apply( std::move( *patch ) );
+	build_minimap( changed );
+}
+
+void TilePaintingGame::build_minimap( GridRegion region )
+{
+	const glm::ivec2 world_dimension = level.dimension();
+
+	minimap_rows.resize( world_dimension[1] );
+
+	for( int line = region.min[1]; line < region.max[1]; ++line ) {
+		auto &runs = minimap_rows[line];
+		runs.clear();
+
+		for( int column = 0; column < world_dimension[0]; ) {
+			if( !level.is_wall( { column, line } ) ) {
+				++column;
+				continue;
+			}
+
+			const int first = column;
+			while( column < world_dimension[0] && level.is_wall( { column, line } ) )
+				++column;
+
+			runs.emplace_back(
+				glm::vec4( static_cast<float>( first ) * unit_size, static_cast<float>( line ) * unit_size, 0.0F, 1.0F ),
+				glm::vec4( static_cast<float>( column ) * unit_size, static_cast<float>( line + 1 ) * unit_size, 0.0F,
+						   1.0F ) );
+		}
+	}
+}
+
 void TilePaintingGame::paint_level()
 {
 	constexpr glm::vec4 white = { 1.0F, 1.0F, 1.0F, 1.0F };
 	constexpr glm::vec4 black = { 0.0F, 0.0F, 0.0F, 1.0F };
 
-	std::pair<glm::vec4, glm::vec4> rect_points;
+	const glm::ivec2 world_dimension = level.dimension();
 
-	for( int cell = 0; cell < world_dimension[0] * world_dimension[1]; ++cell ) {
-		rect_points.first = glm::vec4{ static_cast<float>( cell % world_dimension[0] ) * unit_size,
-									   /* trunk-ignore(clang-tidy/bugprone-integer-division) */
-									   static_cast<float>( cell / world_dimension[0] ) * unit_size, 0.0F, 1.0F };
-		rect_points.second = rect_points.first + glm::vec4( unit_size, unit_size, 0.0F, 1.0F );
+	draw_rect( { glm::vec4( 0.0F, 0.0F, 0.0F, 1.0F ),
+				 glm::vec4( static_cast<float>( world_dimension[0] ) * unit_size,
+							static_cast<float>( world_dimension[1] ) * unit_size, 0.0F, 1.0F ) },
+			   black );
 
-		draw_rect( rect_points, ( level[cell] == '1' ) ? white : black );
-	}
+	for( const auto &runs : minimap_rows )
+		for( const auto &run : runs )
+			draw_rect( run, white );
 }
 
 void TilePaintingGame::paint_camera()
@@ -248,57 +350,3 @@ void TilePaintingGame::paint_character()
 
 	draw_point( player_position, 6.0, yellow );
 }
-
-// adapted based on https://www.youtube.com/watch?v=NbSee-XM7WA
-std::pair<int, glm::vec2> TilePaintingGame::calc_intersection( float angle, glm::vec2 ray_start )
-{
-	constexpr int x_dim = 0;
-	constexpr int y_dim = 1;
-
-	const glm::vec2 ray_dir = { std::cos( angle ), std::sin( angle ) };
-
-	const glm::ivec2 step = { ( ray_dir[x_dim] < 0 ) ? -1 : 1, ( ray_dir[y_dim] < 0 ) ? -1 : 1 };
-
-	const glm::vec2 unit_step_size = {
-		std::sqrt( 1 + ( ray_dir[y_dim] / ray_dir[x_dim] ) * ( ray_dir[y_dim] / ray_dir[x_dim] ) ),
-		std::sqrt( 1 + ( ray_dir[x_dim] / ray_dir[y_dim] ) * ( ray_dir[x_dim] / ray_dir[y_dim] ) ) };
-
-	glm::ivec2 cell_to_test = ray_start;
-	const glm::vec2 first_offset = ( ray_start - glm::vec2( cell_to_test ) );
-	glm::vec2 ray_length_by_dimension = {
-		( ( ray_dir[x_dim] < 0 ) ? first_offset[x_dim] : ( 1.0F - first_offset[x_dim] ) ) * unit_step_size[x_dim],
-		( ( ray_dir[y_dim] < 0 ) ? first_offset[y_dim] : ( 1.0F - first_offset[y_dim] ) ) * unit_step_size[y_dim] };
-
-	constexpr float max_distance = 100.0;
-	float current_side_distance = 0.0;
-	bool wall_found = false;
-	int walk_side = -1;
-
-	while( !wall_found && current_side_distance < max_distance ) {
-
-		walk_side = ( ray_length_by_dimension[x_dim] < ray_length_by_dimension[y_dim] ) ? x_dim : y_dim;
-
-		cell_to_test[walk_side] += step[walk_side];
-		current_side_distance = ray_length_by_dimension[walk_side];
-		ray_length_by_dimension[walk_side] += unit_step_size[walk_side];
-
-		wall_found = is_wall( cell_to_test );
-	}
-
-	if( !wall_found )
-		return std::make_pair( -1, glm::vec2() );
-
-	return std::make_pair( walk_side, glm::vec2( { ray_start + ray_dir * current_side_distance } ) );
-}
-
-bool TilePaintingGame::is_wall( glm::ivec2 cell )
-{
-	constexpr int x_dim = 0;
-	constexpr int y_dim = 1;
-
-	if( cell[x_dim] < 0 || cell[x_dim] > world_dimension[x_dim] || cell[y_dim] < 0 ||
-		cell[y_dim] > world_dimension[y_dim] )
-		return false;
-
-	return level[cell[x_dim] + cell[y_dim] * world_dimension[x_dim]] == '1';
-}
\ No newline at end of file
@@ -19,46 +19,77 @@
 
 #pragma once
 
+#include "grid.h"
+#include "hit_buffer.h"
+#include "level_watcher.h"
+#include "perf_counters.h"
+#include "ray_cast.h"
 #include "sdl2wrapper.h"
+#include "shade.h"
+
+#include <array>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
 
 #include <glm/glm.hpp>
 
 class TilePaintingGame : public Game
 {
+public:
+	// read the level from a file instead of the built-in one, and reload it whenever the file changes
+	void set_level_path( std::string path ) { level_path = std::move( path ); }
+
 private:
 	SetupParams get_params() override;
-	void setup() override{};
+	void setup() override;
 	bool process_event( SDL_Event &event ) override;
 	void update_state( uint64_t elapsed_time ) override;
+	void update_player_matrix();
 	void draw_frame() override;
+	uint32_t get_input_state() override { return key_state; }
+	void set_input_state( uint32_t state ) override { key_state = static_cast<uint8_t>( state ); }
 
 	void paint_floor();
 	void paint_ceiling();
-	void paint_rays();
+	void cast_walls();
+	void paint_walls();
+	void reload_level();
+	void build_minimap( GridRegion region );
 	void paint_grid();
 	void paint_level();
 	void paint_camera();
 	void paint_character();
 
-	bool is_wall( glm::ivec2 cell );
-	std::pair<int, glm::vec2> calc_intersection( float angle, glm::vec2 ray_start );
+	Grid level{ { 10, 10 },
+				"1111111111"
+				"1000100001"
+				"1000100001"
+				"1000100001"
+				"1000000001"
+				"1000000001"
+				"1000000001"
+				"1000001001"
+				"1000000001"
+				"1111011111" };
 
-	std::string level = "1111111111"
-						"1000100001"
-						"1000100001"
-						"1000100001"
-						"1000000001"
-						"1000000001"
-						"1000000001"
-						"1000001001"
-						"1000000001"
-						"1111011111";
+	std::string level_path;
+	std::optional<LevelWatcher> level_watcher;
 
-	glm::ivec2 world_dimension{ 10, 10 };
+	// the wall runs of each grid row, in minimap coordinates, rebuilt only for the rows a reload touched
+	std::vector<std::vector<std::pair<glm::vec4, glm::vec4>>> minimap_rows;
 
 	const int screen_width = 640;
 	const int screen_height = 480;
 
+	HitBuffer ray_hits = HitBuffer( screen_width + 1 );
+	ColumnSpans wall_spans;
+
+	// only does anything when built with RAYCAST_PERF_COUNTERS
+	PerfCounters perf_counters;
+	std::array<PerfPhase, 2> perf_phases = { { { "cast" }, { "draw" } } };
+
 	float unit_size = 10.0F;
 
 	bool quit = false;
@@ -76,5 +107,5 @@ private:
 	float player_angle = 0.0;
 	float player_zoom = 0.4;
 
-	glm::mat4 player_matrix;
+	glm::mat4 player_matrix{ 1.0F };
 };
\ No newline at end of file
@@ -0,0 +1,77 @@
+/*
+ * testcapture.cc Copyright 2024 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#include "testcapture.h"
+
+CPPUNIT_TEST_SUITE_REGISTRATION( TestCapture );
+
+#include "capture_format.h"
+
+#include <array>
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+// two by two, as glReadPixels returns it: the bottom row is black, the top row white then red
+constexpr std::array<uint8_t, 16> frame = {
+	0, 0, 0, 255, 0, 0, 0, 255, 255, 255, 255, 255, 255, 0, 0, 255,
+};
+
+std::string write( CaptureFormat format )
+{
+	std::ostringstream stream;
+	std::vector<uint8_t> scratch;
+
+	write_capture_frame( stream, format, frame.data(), 2, 2, scratch );
+
+	return stream.str();
+}
+
+std::string bytes( std::initializer_list<int> values )
+{
+	std::string result;
+	for( const int value : values )
+		result.push_back( static_cast<char>( value ) );
+	return result;
+}
+
+} // namespace
+
+void TestCapture::raw_rows_top_down()
+{
+	CPPUNIT_ASSERT( write( CaptureFormat::raw ) ==
+					bytes( { 255, 255, 255, 255, 255, 0, 0, 255, 0, 0, 0, 255, 0, 0, 0, 255 } ) );
+}
+
+void TestCapture::ppm_drops_alpha()
+{
+	CPPUNIT_ASSERT( write( CaptureFormat::ppm ) ==
+					"P6\n2 2\n255\n" + bytes( { 255, 255, 255, 255, 0, 0, 0, 0, 0, 0, 0, 0 } ) );
+}
+
+// studio swing: white is Y 235, black Y 16, red Y 82 Cb 90 Cr 240, greys keep Cb and Cr at 128
+void TestCapture::y4m_bt601_planes()
+{
+	CPPUNIT_ASSERT( write( CaptureFormat::y4m ) ==
+					"FRAME\n" + bytes( { 235, 82, 16, 16, 128, 90, 128, 128, 128, 240, 128, 128 } ) );
+}
@@ -0,0 +1,42 @@
+/*
+ * testcapture.h Copyright 2024 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#ifndef TESTCAPTURE_H
+#define TESTCAPTURE_H
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+class TestCapture : public CppUnit::TestFixture
+{
+	CPPUNIT_TEST_SUITE( TestCapture );
+
+	CPPUNIT_TEST( raw_rows_top_down );
+	CPPUNIT_TEST( ppm_drops_alpha );
+	CPPUNIT_TEST( y4m_bt601_planes );
+
+	CPPUNIT_TEST_SUITE_END();
+
+private:
+	static void raw_rows_top_down();
+	static void ppm_drops_alpha();
+	static void y4m_bt601_planes();
+};
+
+#endif // TESTCAPTURE_H
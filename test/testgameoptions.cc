@@ -0,0 +1,64 @@
+/*
+ * testgameoptions.cc Copyright 2024 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#include "testgameoptions.h"
+
+CPPUNIT_TEST_SUITE_REGISTRATION( TestGameOptions );
+
+#include "game_options.h"
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+GameOptions parse( std::vector<std::string> words )
+{
+	std::vector<char *> args;
+	for( std::string &word : words )
+		args.push_back( word.data() );
+
+	return parse_game_options( args );
+}
+
+} // namespace
+
+void TestGameOptions::options_and_arguments()
+{
+	const GameOptions options = parse( { "game", "height.pgm", "--capture", "run.y4m", "--record", "input.log",
+										 "--level", "level.map" } );
+
+	CPPUNIT_ASSERT( options.capture.path == "run.y4m" );
+	CPPUNIT_ASSERT( options.capture.format == CaptureFormat::y4m );
+	CPPUNIT_ASSERT( options.record_path == "input.log" );
+	CPPUNIT_ASSERT( options.replay_path.empty() );
+	CPPUNIT_ASSERT( ( options.arguments == std::vector<std::string>{ "height.pgm", "--level", "level.map" } ) );
+}
+
+void TestGameOptions::record_with_replay_throws()
+{
+	CPPUNIT_ASSERT_THROW( parse( { "game", "--record", "a.log", "--replay", "b.log" } ), std::invalid_argument );
+}
+
+void TestGameOptions::missing_value_throws()
+{
+	CPPUNIT_ASSERT_THROW( parse( { "game", "--replay" } ), std::invalid_argument );
+}
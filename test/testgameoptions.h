@@ -0,0 +1,42 @@
+/*
+ * testgameoptions.h Copyright 2024 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#ifndef TESTGAMEOPTIONS_H
+#define TESTGAMEOPTIONS_H
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+class TestGameOptions : public CppUnit::TestFixture
+{
+	CPPUNIT_TEST_SUITE( TestGameOptions );
+
+	CPPUNIT_TEST( options_and_arguments );
+	CPPUNIT_TEST( record_with_replay_throws );
+	CPPUNIT_TEST( missing_value_throws );
+
+	CPPUNIT_TEST_SUITE_END();
+
+private:
+	static void options_and_arguments();
+	static void record_with_replay_throws();
+	static void missing_value_throws();
+};
+
+#endif // TESTGAMEOPTIONS_H
@@ -0,0 +1,118 @@
+/*
+ * testinputlog.cc Copyright 2024 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#include "testinputlog.h"
+
+CPPUNIT_TEST_SUITE_REGISTRATION( TestInputLog );
+
+#include "input_recording.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+std::string log_path( const std::string &name )
+{
+	return ( std::filesystem::temp_directory_path() / ( "raycast_" + name + ".log" ) ).string();
+}
+
+} // namespace
+
+// values from one to ten varint bytes, including the widest elapsed time
+void TestInputLog::ticks_round_trip()
+{
+	const std::vector<input_log::Tick> ticks = { { 0, 0 },
+												 { 0x7F, 16 },
+												 { 0x80, 0x3FFF },
+												 { 0x4000, 0x1'0000'0000 },
+												 { std::numeric_limits<uint32_t>::max(),
+												   std::numeric_limits<uint64_t>::max() } };
+
+	const std::string path = log_path( "round_trip" );
+
+	{
+		InputRecorder recorder( path );
+		for( const input_log::Tick tick : ticks )
+			recorder.record( tick );
+	}
+
+	InputReplayer replayer( path );
+
+	for( const input_log::Tick expected : ticks ) {
+		const std::optional<input_log::Tick> tick = replayer.next();
+
+		CPPUNIT_ASSERT( tick );
+		CPPUNIT_ASSERT_EQUAL( expected.input_state, tick->input_state );
+		CPPUNIT_ASSERT_EQUAL( expected.elapsed_time, tick->elapsed_time );
+	}
+
+	CPPUNIT_ASSERT( !replayer.next() );
+
+	std::filesystem::remove( path );
+}
+
+void TestInputLog::bad_header_throws()
+{
+	const std::string path = log_path( "bad_header" );
+
+	std::ofstream( path, std::ios::binary ) << "RCIX" << input_log::version;
+	CPPUNIT_ASSERT_THROW( InputReplayer{ path }, std::runtime_error );
+
+	std::ofstream( path, std::ios::binary ) << "RCIN" << static_cast<char>( input_log::version + 1 );
+	CPPUNIT_ASSERT_THROW( InputReplayer{ path }, std::runtime_error );
+
+	std::ofstream( path, std::ios::binary ) << "RC";
+	CPPUNIT_ASSERT_THROW( InputReplayer{ path }, std::runtime_error );
+
+	std::filesystem::remove( path );
+}
+
+// a run killed mid write leaves an input state without its elapsed time, replay stops before it
+void TestInputLog::truncated_tick_ends_replay()
+{
+	const std::string path = log_path( "truncated" );
+
+	{
+		InputRecorder recorder( path );
+		recorder.record( { 5, 300 } );
+	}
+
+	// a two byte input state, then a continuation byte of an elapsed time that never arrives
+	std::ofstream( path, std::ios::binary | std::ios::app ) << static_cast<char>( 0x85 ) << static_cast<char>( 0x01 )
+															<< static_cast<char>( 0x90 );
+
+	InputReplayer replayer( path );
+
+	const std::optional<input_log::Tick> tick = replayer.next();
+	CPPUNIT_ASSERT( tick );
+	CPPUNIT_ASSERT_EQUAL( uint32_t{ 5 }, tick->input_state );
+	CPPUNIT_ASSERT_EQUAL( uint64_t{ 300 }, tick->elapsed_time );
+
+	CPPUNIT_ASSERT( !replayer.next() );
+	CPPUNIT_ASSERT( !replayer.next() );
+
+	std::filesystem::remove( path );
+}
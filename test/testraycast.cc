@@ -0,0 +1,373 @@
+/*
+ * testraycast.cc Copyright 2024 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#include "testraycast.h"
+
+CPPUNIT_TEST_SUITE_REGISTRATION( TestRayCast );
+
+#include "grid.h"
+#include "level_watcher.h"
+#include "perf_counters.h"
+#include "ray_cast.h"
+#include "render_view.h"
+#include "segment_world.h"
+#include "shade.h"
+#include "terrain.h"
+#include "worker_pool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+// a closed room with a gap in the middle of the bottom wall
+Grid make_room()
+{
+	return { { 5, 5 },
+			 "11111"
+			 "10001"
+			 "10001"
+			 "10001"
+			 "11011" };
+}
+
+} // namespace
+
+void TestRayCast::walls_outside_grid()
+{
+	const Grid grid = make_room();
+
+	CPPUNIT_ASSERT( grid.is_wall( { 0, 0 } ) );
+	CPPUNIT_ASSERT( grid.is_wall( { 4, 4 } ) );
+	CPPUNIT_ASSERT( !grid.is_wall( { 2, 4 } ) );
+	CPPUNIT_ASSERT( !grid.is_wall( { 5, 0 } ) );
+	CPPUNIT_ASSERT( !grid.is_wall( { 0, 5 } ) );
+	CPPUNIT_ASSERT( !grid.is_wall( { -1, 2 } ) );
+}
+
+void TestRayCast::centre_ray_distance()
+{
+	const Grid grid = make_room();
+
+	// with two rays the second one points straight down the view direction
+	HitBuffer hits( 2 );
+
+	cast_rays( grid, Camera{ { 2.5F, 2.25F }, 0.0F, 0.4F }, hits );
+
+	CPPUNIT_ASSERT_EQUAL( int8_t( 0 ), hits.side[1] );
+	CPPUNIT_ASSERT_EQUAL( grid.cell_index( { 4, 2 } ), hits.cell[1] );
+	CPPUNIT_ASSERT( std::fabs( hits.distance[1] - 1.5F ) < 0.0001F );
+	CPPUNIT_ASSERT( std::fabs( hits.texture_u[1] - 0.25F ) < 0.0001F );
+
+	cast_rays( grid, Camera{ { 2.5F, 2.5F }, glm::radians( -90.0F ), 0.4F }, hits );
+
+	CPPUNIT_ASSERT_EQUAL( int8_t( 1 ), hits.side[1] );
+	CPPUNIT_ASSERT_EQUAL( grid.cell_index( { 2, 0 } ), hits.cell[1] );
+	CPPUNIT_ASSERT( std::fabs( hits.distance[1] - 1.5F ) < 0.0001F );
+}
+
+void TestRayCast::ray_through_gap()
+{
+	const Grid grid = make_room();
+
+	HitBuffer hits( 2 );
+
+	cast_rays( grid, Camera{ { 2.5F, 2.5F }, glm::radians( 90.0F ), 0.01F }, hits );
+
+	CPPUNIT_ASSERT_EQUAL( int8_t( -1 ), hits.side[1] );
+	CPPUNIT_ASSERT_EQUAL( -1, hits.cell[1] );
+}
+
+void TestRayCast::shade_spans()
+{
+	HitBuffer hits( 3 );
+
+	hits.distance = { 2.0F, 0.0F, 0.5F };
+	hits.side = { 0, -1, 1 };
+
+	ColumnSpans spans;
+	shade_columns( hits, 100.0F, 480, spans );
+
+	CPPUNIT_ASSERT_EQUAL( 190, spans.top[0] );
+	CPPUNIT_ASSERT_EQUAL( 290, spans.bottom[0] );
+	CPPUNIT_ASSERT_EQUAL( uint8_t( 1 ), spans.shade[0] );
+
+	CPPUNIT_ASSERT_EQUAL( spans.top[1], spans.bottom[1] );
+	CPPUNIT_ASSERT_EQUAL( uint8_t( 0 ), spans.shade[1] );
+
+	CPPUNIT_ASSERT_EQUAL( 40, spans.top[2] );
+	CPPUNIT_ASSERT_EQUAL( 440, spans.bottom[2] );
+	CPPUNIT_ASSERT_EQUAL( uint8_t( 2 ), spans.shade[2] );
+}
+
+void TestRayCast::parallel_strips_match()
+{
+	const Grid grid = make_room();
+	const Camera camera{ { 1.5F, 1.5F }, glm::radians( 30.0F ), 0.4F };
+
+	FrameBuffer whole( 96, 64 );
+	FrameBuffer striped( 96, 64 );
+
+	const std::vector<Viewport> viewports = tile_viewports( 4, whole.width, whole.height );
+
+	for( const Viewport &viewport : viewports )
+		render_view( grid, camera, viewport, whole );
+
+	WorkerPool workers( 4 );
+	constexpr int strip_width = 5;
+
+	for( int pass = 0; pass < 3; ++pass )
+		workers.run( viewports.size() * 10, [&]( size_t index ) {
+			const Viewport &viewport = viewports[index / 10];
+			const int first_column = static_cast<int>( index % 10 ) * strip_width;
+
+			render_view_columns( grid, camera, viewport, first_column,
+								 std::max( 0, std::min( strip_width, viewport.width - first_column ) ), striped );
+		} );
+
+	CPPUNIT_ASSERT( whole.pixels == striped.pixels );
+}
+
+void TestRayCast::segment_tree_matches_brute_force()
+{
+	constexpr int wall_count = 2000;
+
+	srand( 1234 );
+
+	const auto random_coord = []() { return static_cast<float>( rand() % 10000 ) / 100.0F; };
+
+	std::vector<Segment> walls;
+	for( int wall = 0; wall < wall_count; ++wall ) {
+		const glm::vec2 from( random_coord(), random_coord() );
+		walls.push_back( { from, from + glm::vec2( random_coord(), random_coord() ) / 20.0F } );
+	}
+
+	const SegmentWorld world( walls );
+
+	for( int ray = 0; ray < 500; ++ray ) {
+		const glm::vec2 origin( random_coord(), random_coord() );
+		const float angle = glm::radians( static_cast<float>( rand() % 3600 ) / 10.0F );
+		const glm::vec2 direction( std::cos( angle ), std::sin( angle ) );
+
+		float nearest = std::numeric_limits<float>::infinity();
+
+		for( const Segment &segment : world.segments() ) {
+			const glm::vec2 edge = segment.to - segment.from;
+			const glm::vec2 to_start = segment.from - origin;
+			const float denominator = direction[0] * edge[1] - direction[1] * edge[0];
+
+			if( std::fabs( denominator ) < 1e-9F )
+				continue;
+
+			const float distance = ( to_start[0] * edge[1] - to_start[1] * edge[0] ) / denominator;
+			const float along = ( to_start[0] * direction[1] - to_start[1] * direction[0] ) / denominator;
+
+			if( distance > 0.0F && along >= 0.0F && along <= 1.0F )
+				nearest = std::min( nearest, distance );
+		}
+
+		const SegmentHit hit = world.intersect( origin, direction );
+
+		if( std::isinf( nearest ) )
+			CPPUNIT_ASSERT_EQUAL( -1, hit.segment );
+		else
+			CPPUNIT_ASSERT( hit.segment != -1 && std::fabs( hit.distance - nearest ) < 0.0001F );
+	}
+}
+
+void TestRayCast::segments_from_grid()
+{
+	const Grid grid = make_room();
+	const SegmentWorld world = SegmentWorld::from_grid( grid );
+
+	const Camera camera{ { 2.3F, 1.7F }, glm::radians( 20.0F ), 0.8F };
+
+	HitBuffer grid_hits( 64 );
+	HitBuffer segment_hits( 64 );
+
+	cast_rays( grid, camera, grid_hits );
+	cast_rays( world, camera, segment_hits );
+
+	for( size_t column = 0; column < grid_hits.size(); ++column ) {
+		CPPUNIT_ASSERT_EQUAL( grid_hits.side[column], segment_hits.side[column] );
+		CPPUNIT_ASSERT( std::fabs( grid_hits.distance[column] - segment_hits.distance[column] ) < 0.001F );
+	}
+}
+
+void TestRayCast::terrain_horizon()
+{
+	const Terrain flat( 4, std::vector<TerrainSample>( 16 * 16, { 0, 10, 20, 30 } ) );
+	const Camera camera{ { 3.0F, 5.0F }, glm::radians( 60.0F ), 0.5F };
+	const TerrainView view;
+
+	FrameBuffer frame( 64, 64 );
+	render_terrain( flat, camera, view, { 0, 0, frame.width, frame.height }, frame );
+
+	const auto horizon = static_cast<int>( view.horizon * static_cast<float>( frame.height ) );
+
+	for( int column = 0; column < frame.width; ++column ) {
+		CPPUNIT_ASSERT_EQUAL( view.sky, frame.row( 0 )[column] );
+		CPPUNIT_ASSERT_EQUAL( view.sky, frame.row( horizon - 1 )[column] );
+		CPPUNIT_ASSERT_EQUAL( make_pixel( 10, 20, 30 ), frame.row( horizon + 4 )[column] );
+		CPPUNIT_ASSERT_EQUAL( make_pixel( 10, 20, 30 ), frame.row( frame.height - 1 )[column] );
+	}
+}
+
+void TestRayCast::terrain_strips_match()
+{
+	const Terrain terrain = Terrain::generate( 6, 7 );
+	const Camera camera{ { 20.0F, -3.0F }, glm::radians( 100.0F ), 0.6F };
+	const TerrainView view;
+	const Viewport viewport{ 0, 0, 80, 60 };
+
+	FrameBuffer whole( viewport.width, viewport.height );
+	FrameBuffer striped( viewport.width, viewport.height );
+
+	render_terrain( terrain, camera, view, viewport, whole );
+
+	WorkerPool workers( 4 );
+	constexpr int strip_width = 7;
+
+	workers.run( ( viewport.width + strip_width - 1 ) / strip_width, [&]( size_t index ) {
+		const int first_column = static_cast<int>( index ) * strip_width;
+
+		render_terrain_columns( terrain, camera, view, viewport, first_column,
+								std::min( strip_width, viewport.width - first_column ), striped );
+	} );
+
+	CPPUNIT_ASSERT( whole.pixels == striped.pixels );
+}
+
+// only meaningful where the counters are built in and the kernel lets this process open them
+void TestRayCast::perf_phases_accumulate()
+{
+	const Grid grid = make_room();
+	const Camera camera{ { 1.5F, 1.5F }, 0.0F, 0.4F };
+	HitBuffer hits( 320 );
+
+	PerfCounters counters;
+	PerfPhase phase{ "cast" };
+
+	if( !counters.available() )
+		return;
+
+	counters.begin( phase );
+	cast_rays( grid, camera, hits );
+	counters.end( phase );
+
+	CPPUNIT_ASSERT( phase.measured <= 1 );
+
+	if( phase.measured == 1 )
+		CPPUNIT_ASSERT( phase.total.instructions > 0 );
+}
+
+void TestRayCast::grid_diff_patch()
+{
+	Grid grid( { 4, 3 }, "1111"
+						 "1001"
+						 "1111" );
+
+	CPPUNIT_ASSERT( grid.diff( grid ).region.empty() );
+
+	GridPatch patch = grid.diff( Grid( { 4, 3 }, "1111"
+												"1101"
+												"1110" ) );
+	CPPUNIT_ASSERT( patch.region.min == glm::ivec2( 1, 1 ) );
+	CPPUNIT_ASSERT( patch.region.max == glm::ivec2( 4, 3 ) );
+	CPPUNIT_ASSERT( patch.cells == "101"
+								   "110" );
+
+	grid.apply( std::move( patch ) );
+	CPPUNIT_ASSERT( grid.is_wall( { 0, 1 } ) );
+	CPPUNIT_ASSERT( grid.is_wall( { 1, 1 } ) );
+	CPPUNIT_ASSERT( !grid.is_wall( { 2, 1 } ) );
+	CPPUNIT_ASSERT( !grid.is_wall( { 3, 2 } ) );
+
+	patch = grid.diff( Grid( { 2, 2 }, "1010" ) );
+	CPPUNIT_ASSERT( patch.region.min == glm::ivec2( 0, 0 ) );
+	CPPUNIT_ASSERT( patch.region.max == glm::ivec2( 2, 2 ) );
+
+	grid.apply( std::move( patch ) );
+	CPPUNIT_ASSERT( grid.dimension() == glm::ivec2( 2, 2 ) );
+	CPPUNIT_ASSERT( grid.is_wall( { 0, 1 } ) );
+}
+
+namespace
+{
+
+std::optional<GridPatch> wait_for_patch( LevelWatcher &watcher )
+{
+	std::optional<GridPatch> patch;
+
+	for( int attempt = 0; attempt < 200 && !patch; ++attempt ) {
+		std::this_thread::sleep_for( std::chrono::milliseconds( 10 ) );
+		patch = watcher.poll();
+	}
+
+	return patch;
+}
+
+} // namespace
+
+// saves the way editors do, a new file renamed over the old one
+void TestRayCast::level_watcher_reloads()
+{
+	const std::filesystem::path directory = std::filesystem::temp_directory_path() / "raycast_level_watcher";
+	const std::filesystem::path path = directory / "level.map";
+
+	std::filesystem::create_directories( directory );
+	std::ofstream( path ) << "111\n101\n111\n";
+
+	Grid level = Grid::load( path.string() );
+	LevelWatcher watcher( path, level );
+	CPPUNIT_ASSERT( !watcher.poll() );
+
+	std::this_thread::sleep_for( std::chrono::milliseconds( 50 ) );
+
+	std::ofstream( directory / "level.map.new" ) << "111\n111\n111\n";
+	std::filesystem::rename( directory / "level.map.new", path );
+
+	std::optional<GridPatch> patch = wait_for_patch( watcher );
+	CPPUNIT_ASSERT( patch );
+	CPPUNIT_ASSERT( patch->region.min == glm::ivec2( 1, 1 ) );
+	CPPUNIT_ASSERT( patch->region.max == glm::ivec2( 2, 2 ) );
+
+	level.apply( std::move( *patch ) );
+	CPPUNIT_ASSERT( level.is_wall( { 1, 1 } ) );
+	CPPUNIT_ASSERT( !watcher.poll() );
+
+	// the next patch is relative to the level with the first one applied
+	std::this_thread::sleep_for( std::chrono::milliseconds( 50 ) );
+	std::ofstream( path ) << "111\n111\n110\n";
+
+	patch = wait_for_patch( watcher );
+	std::filesystem::remove_all( directory );
+
+	CPPUNIT_ASSERT( patch );
+	CPPUNIT_ASSERT( patch->region.min == glm::ivec2( 2, 2 ) );
+	CPPUNIT_ASSERT( patch->region.max == glm::ivec2( 3, 3 ) );
+}
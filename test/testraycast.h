@@ -0,0 +1,60 @@
+/*
+ * testraycast.h Copyright 2024 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#ifndef TESTRAYCAST_H
+#define TESTRAYCAST_H
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+class TestRayCast : public CppUnit::TestFixture
+{
+	CPPUNIT_TEST_SUITE( TestRayCast );
+
+	CPPUNIT_TEST( walls_outside_grid );
+	CPPUNIT_TEST( centre_ray_distance );
+	CPPUNIT_TEST( ray_through_gap );
+	CPPUNIT_TEST( shade_spans );
+	CPPUNIT_TEST( parallel_strips_match );
+	CPPUNIT_TEST( segment_tree_matches_brute_force );
+	CPPUNIT_TEST( segments_from_grid );
+	CPPUNIT_TEST( terrain_horizon );
+	CPPUNIT_TEST( terrain_strips_match );
+	CPPUNIT_TEST( perf_phases_accumulate );
+	CPPUNIT_TEST( grid_diff_patch );
+	CPPUNIT_TEST( level_watcher_reloads );
+
+	CPPUNIT_TEST_SUITE_END();
+
+private:
+	static void walls_outside_grid();
+	static void centre_ray_distance();
+	static void ray_through_gap();
+	static void shade_spans();
+	static void parallel_strips_match();
+	static void segment_tree_matches_brute_force();
+	static void segments_from_grid();
+	static void terrain_horizon();
+	static void terrain_strips_match();
+	static void perf_phases_accumulate();
+	static void grid_diff_patch();
+	static void level_watcher_reloads();
+};
+
+#endif // TESTRAYCAST_H